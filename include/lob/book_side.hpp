@@ -0,0 +1,55 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory_resource>
+#include <type_traits>
+#include "types.hpp"
+#include "side.hpp"
+#include "price_level.hpp"
+
+namespace lob {
+
+// ------------------------
+// BookSide<S>: compile-time description of one side of the book
+// ------------------------
+// Levels are ordered best price first on both sides (bids descending,
+// asks ascending), so begin() is always the touch and a sweep is a forward
+// walk. Code templated on the side gets its ordering, opposite side and
+// cross test as constants; only the entry points dispatch on Side.
+template<Side S>
+struct BookSide {
+    static constexpr Side side     = S;
+    static constexpr Side opposite = (S == Side::Buy) ? Side::Sell : Side::Buy;
+
+    using Compare = std::conditional_t<S == Side::Buy, std::greater<Price>, std::less<Price>>;
+    using Levels  = std::pmr::map<Price, PriceLevel, Compare>;
+
+    // `a` is a strictly better price than `b` for a resting order on this side
+    static constexpr bool better(Price a, Price b) noexcept { return Compare{}(a, b); }
+
+    // An order on this side at `price` trades with an opposite level at
+    // `level_price` unless that level is beyond its limit
+    static constexpr bool crosses(Price price, Price level_price) noexcept
+    {
+        return !better(level_price, price);
+    }
+
+    static PriceLevel* best(Levels& levels) noexcept
+    {
+        return levels.empty() ? nullptr : &levels.begin()->second;
+    }
+
+    static const PriceLevel* best(const Levels& levels) noexcept
+    {
+        return levels.empty() ? nullptr : &levels.begin()->second;
+    }
+};
+
+using BidSide = BookSide<Side::Buy>;
+using AskSide = BookSide<Side::Sell>;
+
+static_assert(BidSide::crosses(101, 100) && BidSide::crosses(100, 100) && !BidSide::crosses(99, 100));
+static_assert(AskSide::crosses(99, 100) && AskSide::crosses(100, 100) && !AskSide::crosses(101, 100));
+
+} // namespace lob
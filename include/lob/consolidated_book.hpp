@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+#include "order_book.hpp"
+
+namespace lob {
+
+using VenueId = uint32_t;   // position of the book in the ConsolidatedBook
+
+// One venue's level in the consolidated view
+struct VenueLevel {
+    Price price;
+    Quantity volume;
+    VenueId venue;
+};
+
+struct Nbbo {
+    std::optional<VenueLevel> bid;
+    std::optional<VenueLevel> ask;
+};
+
+// ------------------------
+// ConsolidatedBook: merged view over N venue books
+// ------------------------
+// Each side keeps a tournament tree over the venues' cached top-of-book.
+// Venues report top changes through OrderBook's listener, and one update
+// replays the log2(N) matches from that venue's leaf to the root. Books
+// are never rescanned. Equal prices go to the lower venue id.
+//
+// The venue books must outlive this object. A listener already set on a
+// venue keeps firing (before the refresh) and is put back on destruction,
+// so views stacked on one venue must be destroyed in reverse order.
+class ConsolidatedBook {
+public:
+    explicit ConsolidatedBook(std::span<OrderBook* const> venues);
+    ~ConsolidatedBook();
+
+    ConsolidatedBook(const ConsolidatedBook&) = delete;
+    ConsolidatedBook& operator=(const ConsolidatedBook&) = delete;
+
+    std::size_t venue_count() const noexcept { return venues_.size(); }
+
+    // Best level across venues, O(1)
+    std::optional<VenueLevel> best(Side side) const noexcept;
+    Nbbo nbbo() const noexcept { return {best(Side::Buy), best(Side::Sell)}; }
+
+    // Best `out.size()` levels of `side` across venues, best first, one
+    // entry per (venue, price). k-way merge seeded from the n best cached
+    // tops (no venue can place more entries than tops ahead of it):
+    // O(N + n log n) for n = out.size(). Returns the number of entries written.
+    // Merges into per-side scratch sized at construction, so depth() never
+    // allocates but must not run concurrently with itself.
+    std::size_t depth(Side side, std::span<VenueLevel> out) const;
+
+    // Re-read one venue's top of `side` (what the listener calls)
+    void refresh(VenueId venue, Side side);
+
+private:
+    static constexpr uint32_t kNoVenue = UINT32_MAX;
+
+    struct Top {
+        Price price{0};
+        Quantity volume{0};
+        bool present{false};
+    };
+
+    template<Side S>
+    struct Cursor {
+        typename BookSide<S>::Levels::const_iterator it;
+        typename BookSide<S>::Levels::const_iterator end;
+        VenueId venue;
+    };
+
+    template<Side S>
+    std::vector<Cursor<S>>& cursors() const noexcept
+    {
+        if constexpr (S == Side::Buy) return bid_cursors_; else return ask_cursors_;
+    }
+
+    template<Side S> void refresh_side(VenueId venue);
+    template<Side S> uint32_t winner(uint32_t a, uint32_t b) const noexcept;
+    template<Side S> std::size_t merge(std::span<VenueLevel> out) const;
+
+    std::vector<OrderBook*> venues_;
+    std::size_t leaves_;   // power of two >= venue count
+
+    // Indexed [side]: cached tops per venue and a heap-shaped tree of venue
+    // ids (root at 1, leaves at leaves_ + venue)
+    std::vector<Top> tops_[2];
+    std::vector<uint32_t> tree_[2];
+
+    std::vector<TopOfBookListener> chained_;   // per venue: listener found at attach
+
+    // depth() heaps; iterator types differ per side
+    mutable std::vector<Cursor<Side::Buy>> bid_cursors_;
+    mutable std::vector<Cursor<Side::Sell>> ask_cursors_;
+};
+
+/* USAGE: NBBO over three simulated venues
+    std::vector<lob::OrderBook*> venues = {&a.book(), &b.book(), &c.book()};
+    lob::ConsolidatedBook sip(venues);
+
+    auto [bid, ask] = sip.nbbo();             // venue-attributed
+    std::array<lob::VenueLevel, 10> ladder;
+    std::size_t n = sip.depth(Side::Sell, ladder);
+*/
+
+} // namespace lob
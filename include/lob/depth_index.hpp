@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+#include "types.hpp"
+#include "side.hpp"
+
+namespace lob {
+
+// Result of sweeping resting liquidity best price first
+struct SweepCost {
+    Quantity filled{0};      // < requested when the indexed depth runs out
+    Quantity notional{0};    // sum of price * qty over the fills
+    Price worst_price{0};    // last level touched (0 if nothing filled)
+
+    double vwap() const noexcept
+    {
+        return filled ? static_cast<double>(notional) / static_cast<double>(filled) : 0.0;
+    }
+};
+
+// Cumulative depth over a fixed price window [lo, hi], one Fenwick tree of
+// volume and one of notional per side. Ranks run from the touch outwards:
+// asks by ascending price, bids mirrored (hi - price), so every prefix is
+// "at this price or better". Updates and queries are O(log window).
+//
+// Levels outside the window are not indexed; size the window to cover the
+// prices the queries care about.
+class DepthIndex {
+public:
+    DepthIndex(Price lo, Price hi, std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+
+    Price lo() const noexcept { return lo_; }
+    Price hi() const noexcept { return hi_; }
+    bool covers(Price price) const noexcept { return price >= lo_ && price <= hi_; }
+
+    // Level volume at `price` changed by `qty` (negative for fills/removals)
+    void add(Side side, Price price, Quantity qty) noexcept
+    {
+        if (!covers(price)) return;
+
+        const int s = static_cast<int>(side);
+        const Quantity notional = price * qty;
+        for (std::size_t i = rank(side, price); i <= size_; i += i & (~i + 1)) {
+            volume_[s][i]   += qty;
+            notional_[s][i] += notional;
+        }
+    }
+
+    // ---- Queries; `side` is the resting side being swept ----
+
+    // Resting volume priced at `price` or better
+    Quantity price_to_volume(Side side, Price price) const noexcept;
+
+    // Price at which cumulative depth first reaches `qty`;
+    // nullopt if the indexed depth is smaller than `qty`
+    std::optional<Price> volume_to_price(Side side, Quantity qty) const noexcept;
+
+    // Cost of taking `qty` from `side` (partial if the depth runs out)
+    SweepCost vwap_for_quantity(Side side, Quantity qty) const noexcept;
+
+    Quantity total_volume(Side side) const noexcept
+    {
+        return price_to_volume(side, side == Side::Buy ? lo_ : hi_);
+    }
+
+    void clear(Side side) noexcept;
+
+private:
+    std::size_t rank(Side side, Price price) const noexcept
+    {
+        return static_cast<std::size_t>(side == Side::Buy ? hi_ - price : price - lo_) + 1;
+    }
+
+    Price price_at(Side side, std::size_t rank) const noexcept
+    {
+        const Price offset = static_cast<Price>(rank) - 1;
+        return side == Side::Buy ? hi_ - offset : lo_ + offset;
+    }
+
+    // Largest rank whose prefix volume is < qty, with that prefix's sums
+    std::size_t descend(int s, Quantity qty, Quantity& volume, Quantity& notional) const noexcept;
+
+    Price lo_;
+    Price hi_;
+    std::size_t size_;
+    std::size_t top_bit_;   // highest power of two <= size_
+
+    // 1-based Fenwick arrays, indexed [side][rank]
+    std::pmr::vector<Quantity> volume_[2];
+    std::pmr::vector<Quantity> notional_[2];
+};
+
+} // namespace lob
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <memory_resource>
+#include <stdexcept>
+#include <vector>
+#include "replay.hpp"
+
+namespace lob {
+
+struct FeatureConfig {
+    Timestamp window_ns{1'000'000'000};   // rolling VWAP / trade intensity window; > 0
+};
+
+// ------------------------
+// FeatureColumns: one row per book update, struct-of-arrays
+// ------------------------
+// Each column is a contiguous array that can be handed to numpy/arrow
+// (or any ML loader) through data() and size() without conversion.
+struct FeatureColumns {
+    explicit FeatureColumns(std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : ts(mr), mid(mr), spread(mr), microprice(mr), imbalance(mr),
+          ofi(mr), vwap(mr), trade_intensity(mr) {}
+
+    std::pmr::vector<Timestamp> ts;
+    std::pmr::vector<double> mid;               // one-sided book: that side's best
+    std::pmr::vector<double> spread;            // 0 unless both sides are present
+    std::pmr::vector<double> microprice;        // size-weighted touch (= mid if one-sided)
+    std::pmr::vector<double> imbalance;         // top-N (bid - ask) / (bid + ask) volume
+    std::pmr::vector<double> ofi;               // order-flow imbalance at the touch since the last row
+    std::pmr::vector<double> vwap;              // trades in the rolling window (0 if none)
+    std::pmr::vector<double> trade_intensity;   // trades per second in the rolling window
+
+    std::size_t size() const noexcept { return ts.size(); }
+
+    void reserve(std::size_t rows)
+    {
+        for (auto* c : {&mid, &spread, &microprice, &imbalance, &ofi, &vwap, &trade_intensity}) c->reserve(rows);
+        ts.reserve(rows);
+    }
+
+    void clear() noexcept
+    {
+        for (auto* c : {&mid, &spread, &microprice, &imbalance, &ofi, &vwap, &trade_intensity}) c->clear();
+        ts.clear();
+    }
+};
+
+// Best N levels of one side, best first; unused slots are zero
+template<std::size_t N>
+struct TopLevels {
+    alignas(64) std::array<Price, N> price{};
+    alignas(64) std::array<Quantity, N> qty{};
+    std::size_t depth{0};
+};
+
+// ------------------------
+// FeatureEngine<N>: microstructure features over the top N levels
+// ------------------------
+// A strategy: run it through PaperTradingEngine-style replays, StrategyEngine
+// or PipelinedReplay (matching stage). on_trade feeds the rolling window;
+// on_book_update refreshes the fixed-size ladders and appends one row.
+// Trade-window state is updated per trade and evicted by timestamp, so
+// each row costs O(N) plus the trades leaving the window.
+//
+// The ladders are not maintained incrementally: on_book_update re-reads
+// the best N levels of each side on every event (N map steps per side),
+// because the book reports level changes only at the touch and the depth
+// index is cumulative over a fixed price window, not a top-N view. Keep N
+// to the handful of levels the features need.
+template<std::size_t N>
+class FeatureEngine {
+    static_assert(N > 0, "FeatureEngine needs at least one level per side");
+
+public:
+    explicit FeatureEngine(FeatureConfig config = {},
+                           std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : config_(config), columns_(mr), window_(mr)
+    {
+        if (config_.window_ns == 0) throw std::invalid_argument("FeatureEngine: zero trade window");
+    }
+
+    void on_trade(const TradeEvent& t)
+    {
+        window_.push_back({t.ts, t.price, t.quantity});
+        window_notional_ += static_cast<double>(t.price) * static_cast<double>(t.quantity);
+        window_qty_      += t.quantity;
+        evict(t.ts);
+    }
+
+    void on_book_update(const OrderBook& book, const HistoricalEvent& e)
+    {
+        const TopLevels<N> prev_bids = bids_;
+        const TopLevels<N> prev_asks = asks_;
+        load(book.bids(), bids_);
+        load(book.asks(), asks_);
+        evict(e.ts);
+
+        const bool has_bid = bids_.depth > 0;
+        const bool has_ask = asks_.depth > 0;
+        const double pb = static_cast<double>(bids_.price[0]);
+        const double pa = static_cast<double>(asks_.price[0]);
+        const double qb = static_cast<double>(bids_.qty[0]);
+        const double qa = static_cast<double>(asks_.qty[0]);
+
+        double mid = 0.0, spread = 0.0, micro = 0.0;
+        if (has_bid && has_ask) {
+            mid    = 0.5 * (pb + pa);
+            spread = pa - pb;
+            micro  = (pa * qb + pb * qa) / (qa + qb);
+        } else if (has_bid || has_ask) {
+            mid = micro = has_bid ? pb : pa;
+        }
+
+        const double bid_volume = static_cast<double>(sum(bids_.qty));
+        const double ask_volume = static_cast<double>(sum(asks_.qty));
+        const double total = bid_volume + ask_volume;
+
+        const double seconds = static_cast<double>(config_.window_ns) * 1e-9;
+
+        columns_.ts.push_back(e.ts);
+        columns_.mid.push_back(mid);
+        columns_.spread.push_back(spread);
+        columns_.microprice.push_back(micro);
+        columns_.imbalance.push_back(total > 0 ? (bid_volume - ask_volume) / total : 0.0);
+        columns_.ofi.push_back(has_rows_ ? touch_flow(prev_bids, prev_asks) : 0.0);
+        columns_.vwap.push_back(window_qty_ ? window_notional_ / static_cast<double>(window_qty_) : 0.0);
+        columns_.trade_intensity.push_back(static_cast<double>(window_.size()) / seconds);
+        has_rows_ = true;
+    }
+
+    const FeatureColumns& features() const noexcept { return columns_; }
+    FeatureColumns& features() noexcept { return columns_; }
+
+    const TopLevels<N>& bids() const noexcept { return bids_; }
+    const TopLevels<N>& asks() const noexcept { return asks_; }
+
+private:
+    struct WindowTrade {
+        Timestamp ts;
+        Price price;
+        Quantity qty;
+    };
+
+    template<typename Levels>
+    static void load(const Levels& levels, TopLevels<N>& out) noexcept
+    {
+        // Levels are stored best first on both sides
+        std::size_t i = 0;
+        for (auto it = levels.begin(); it != levels.end() && i < N; ++it, ++i) {
+            out.price[i] = it->first;
+            out.qty[i]   = it->second.total_volume;
+        }
+        out.depth = i;
+        for (; i < N; ++i) {
+            out.price[i] = 0;
+            out.qty[i]   = 0;
+        }
+    }
+
+    static Quantity sum(const std::array<Quantity, N>& q) noexcept
+    {
+        Quantity s = 0;
+        for (std::size_t i = 0; i < N; ++i) s += q[i];   // fixed trip count: vectorises
+        return s;
+    }
+
+    // Cont/Kukanov/Stoikov OFI between the previous and current touch
+    double touch_flow(const TopLevels<N>& prev_bids, const TopLevels<N>& prev_asks) const noexcept
+    {
+        double flow = 0.0;
+        if (bids_.depth && prev_bids.depth) {
+            if (bids_.price[0] >= prev_bids.price[0]) flow += static_cast<double>(bids_.qty[0]);
+            if (bids_.price[0] <= prev_bids.price[0]) flow -= static_cast<double>(prev_bids.qty[0]);
+        } else {
+            flow += static_cast<double>(bids_.qty[0] - prev_bids.qty[0]);
+        }
+        if (asks_.depth && prev_asks.depth) {
+            if (asks_.price[0] <= prev_asks.price[0]) flow -= static_cast<double>(asks_.qty[0]);
+            if (asks_.price[0] >= prev_asks.price[0]) flow += static_cast<double>(prev_asks.qty[0]);
+        } else {
+            flow -= static_cast<double>(asks_.qty[0] - prev_asks.qty[0]);
+        }
+        return flow;
+    }
+
+    void evict(Timestamp now) noexcept
+    {
+        while (!window_.empty() && window_.front().ts + config_.window_ns <= now) {
+            const WindowTrade& t = window_.front();
+            window_notional_ -= static_cast<double>(t.price) * static_cast<double>(t.qty);
+            window_qty_      -= t.qty;
+            window_.pop_front();
+        }
+        if (window_.empty()) window_notional_ = 0.0;   // no drift from repeated +/-
+    }
+
+    FeatureConfig config_;
+    FeatureColumns columns_;
+
+    TopLevels<N> bids_;
+    TopLevels<N> asks_;
+    bool has_rows_{false};
+
+    std::pmr::deque<WindowTrade> window_;
+    double window_notional_{0.0};
+    Quantity window_qty_{0};
+};
+
+/* USAGE: Feature rows alongside a replay
+    lob::StrategyEngine<lob::FeatureEngine<5>> replay(1 << 20);
+    replay.feed_events(events);
+
+    const auto& f = replay.strategy().features();
+    // f.microprice.data(), f.ofi.data(), ... one row per event
+*/
+
+} // namespace lob
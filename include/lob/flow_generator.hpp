@@ -0,0 +1,248 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+#include "replay.hpp"
+
+namespace lob {
+
+// ------------------------
+// Xoshiro256x4: four interleaved xoshiro256** streams
+// ------------------------
+// State is laid out [word][lane] so the update is the same four-wide
+// operation on each word; compilers turn fill() into SIMD code (AVX2 on
+// x86-64 when enabled) without intrinsics. Output is lane-interleaved.
+class Xoshiro256x4 {
+public:
+    static constexpr std::size_t kLanes = 4;
+
+    explicit Xoshiro256x4(uint64_t seed) noexcept
+    {
+        // splitmix64 expands the seed into 16 well-mixed state words
+        uint64_t x = seed;
+        for (auto& word : s_) {
+            for (auto& lane : word) {
+                uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                lane = z ^ (z >> 31);
+            }
+        }
+    }
+
+    // `out.size()` must be a multiple of kLanes
+    void fill(std::span<uint64_t> out) noexcept
+    {
+        for (std::size_t i = 0; i < out.size(); i += kLanes) {
+            for (std::size_t l = 0; l < kLanes; ++l) {
+                out[i + l] = rotl(s_[1][l] * 5, 7) * 9;
+
+                const uint64_t t = s_[1][l] << 17;
+                s_[2][l] ^= s_[0][l];
+                s_[3][l] ^= s_[1][l];
+                s_[1][l] ^= s_[2][l];
+                s_[0][l] ^= s_[3][l];
+                s_[2][l] ^= t;
+                s_[3][l] = rotl(s_[3][l], 45);
+            }
+        }
+    }
+
+private:
+    static constexpr uint64_t rotl(uint64_t x, int k) noexcept { return (x << k) | (x >> (64 - k)); }
+
+    alignas(32) uint64_t s_[4][kLanes];
+};
+
+// ------------------------
+// FlowConfig: shape of the synthetic stream
+// ------------------------
+struct FlowConfig {
+    uint64_t seed{1};
+    Timestamp start_ts{0};
+
+    // Arrivals: Hawkes process with exponential kernel, in events/second.
+    // Each arrival lifts the intensity by `excitation`, which decays at
+    // rate `decay`; excitation / decay < 1 keeps it stationary.
+    double base_rate{1e6};
+    double excitation{0.0};
+    double decay{1.0};
+
+    // Prices: geometric distance (mean `mean_distance` ticks) behind the
+    // touch around a mid that random-walks one tick with `mid_step_prob`.
+    // `marketable_ratio` of orders cross instead.
+    Price initial_mid{10'000};
+    double mean_distance{3.0};
+    double marketable_ratio{0.1};
+    double mid_step_prob{0.01};
+
+    Quantity min_qty{1};
+    Quantity max_qty{100};
+
+    // Per new order: probability it is cancelled after an exponential
+    // lifetime (mean `mean_lifetime_ns`), and that it is modified at a
+    // uniform point of that lifetime (size-down or one-tick reprice)
+    double cancel_ratio{0.8};
+    double modify_ratio{0.2};
+    double mean_lifetime_ns{5e6};
+
+    uint32_t participants{0};   // 0: all orders anonymous
+};
+
+// ------------------------
+// FlowGenerator: deterministic HistoricalEvent stream
+// ------------------------
+// Same config and seed, same stream. Order ids and event ids are dense
+// from 1. Cancels and modifies come from a timer queue and may refer to
+// orders the engine has already filled, as real cancel races do.
+//
+// A new order costs four random words, two or three ziggurat exponential
+// draws and about one timer push; arrivals need one log only while the
+// Hawkes excitation is live. That is ~10 M events/s single-threaded in the
+// soak config on the reference VM, ~15-20 M/s as plain Poisson without
+// timers. Run generators with different seeds on separate cores for more.
+class FlowGenerator {
+public:
+    explicit FlowGenerator(const FlowConfig& config);
+
+    HistoricalEvent next();
+
+    // Fill `out` completely; returns out.size()
+    std::size_t generate(std::span<HistoricalEvent> out);
+
+    // Source for PipelinedReplay::run: emits `count` events into `sink`
+    template<typename Sink>
+    void emit(std::size_t count, Sink&& sink)
+    {
+        for (std::size_t i = 0; i < count; ++i) sink(next());
+    }
+
+    Price mid() const noexcept { return mid_; }
+    Timestamp now() const noexcept { return next_arrival_; }
+    std::size_t pending_timers() const noexcept { return timers_.size(); }
+
+private:
+    struct Timer {
+        Timestamp ts;
+        OrderId order_id;
+        Price price;
+        Quantity qty;
+        Side side;
+        EventType type;
+    };
+
+    // Radix heap over timestamps: a timer sits in the bucket named by the
+    // highest bit where its ts differs from the last one popped, so push is
+    // an append and pop only redistributes the lowest non-empty bucket.
+    // Valid because timers are scheduled at or after the arrival creating
+    // them, never before one already popped. Equal ts pop last-in first.
+    class TimerQueue {
+    public:
+        bool empty() const noexcept { return size_ == 0; }
+        std::size_t size() const noexcept { return size_; }
+
+        void push(const Timer& t)
+        {
+            const auto b = static_cast<std::size_t>(std::bit_width(t.ts ^ last_));
+            buckets_[b].push_back(t);
+            mins_[b] = std::min(mins_[b], t.ts);
+            if (b) occupied_ |= uint64_t{1} << (b - 1);
+            ++size_;
+        }
+
+        // Earliest pending ts; the queue must not be empty
+        Timestamp top_ts() const noexcept
+        {
+            if (!buckets_[0].empty()) return last_;
+            return mins_[1 + static_cast<std::size_t>(std::countr_zero(occupied_))];
+        }
+
+        Timer pop();
+
+    private:
+        std::array<std::vector<Timer>, 65> buckets_;
+        std::array<Timestamp, 65> mins_ = [] {
+            std::array<Timestamp, 65> m;
+            m.fill(std::numeric_limits<Timestamp>::max());
+            return m;
+        }();
+        uint64_t occupied_{0};   // bit b - 1 set: bucket b (1..64) non-empty
+        Timestamp last_{0};
+        std::size_t size_{0};
+    };
+
+    uint64_t bits() noexcept
+    {
+        if (rand_pos_ == rand_.size()) {
+            rng_.fill(rand_);
+            rand_pos_ = 0;
+        }
+        return rand_[rand_pos_++];
+    }
+
+    // (0, 1]: safe for log()
+    double uniform() noexcept
+    {
+        return static_cast<double>((bits() >> 11) + 1) * 0x1.0p-53;
+    }
+
+    // Standard exponential variate
+    double exponential() noexcept;
+
+    void refill_background();
+    void advance_arrival();
+    HistoricalEvent new_order();
+
+    FlowConfig config_;
+    Xoshiro256x4 rng_;
+    alignas(64) std::array<uint64_t, 256> rand_{};
+    std::size_t rand_pos_;
+
+    // Background (Poisson) waits in seconds and their intensity decay
+    // factors exp(-decay * wait), drawn a block at a time so the exp runs
+    // off the arrival-to-arrival dependency chain
+    alignas(64) std::array<double, 256> background_wait_{};
+    alignas(64) std::array<double, 256> background_decay_{};
+    std::size_t background_pos_;
+
+    double intensity_;           // Hawkes intensity just after the last arrival
+    double inv_log_distance_;    // 1 / log(1 - p) for the geometric distance
+
+    // FlowConfig probabilities scaled to 2^32, compared against 32 random bits
+    uint64_t mid_step_cut_;
+    uint64_t marketable_cut_;
+    uint64_t cancel_cut_;
+    uint64_t modify_cut_;
+
+    Timestamp next_arrival_;
+    Price mid_;
+
+    EventId next_event_id_{1};
+    OrderId next_order_id_{1};
+
+    TimerQueue timers_;
+};
+
+/* USAGE: Soak a matching engine from a clustered synthetic stream
+    lob::FlowConfig cfg;
+    cfg.seed = 42;
+    cfg.excitation = 0.6e6;   // bursts
+    cfg.decay = 1e6;
+    lob::FlowGenerator flow(cfg);
+
+    std::vector<lob::HistoricalEvent> batch(4096);
+    lob::TradeBuffer trades;
+    for (;;) {
+        flow.generate(batch);
+        for (const auto& e : batch) lob::apply_event(engine, e, trades);
+        trades.clear();
+    }
+*/
+
+} // namespace lob
@@ -0,0 +1,388 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "types.hpp"
+#include "side.hpp"
+#include "replay.hpp"
+#include "memory_resources.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace lob {
+
+// ------------------------
+// MappedFile: read-only mmap of a data file
+// ------------------------
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool open(const std::string& path);
+    void close() noexcept;
+
+    bool is_open() const noexcept { return data_ != nullptr; }
+    std::size_t size() const noexcept { return size_; }
+    std::string_view view() const noexcept { return {data_, size_}; }
+
+private:
+    const char* data_{nullptr};
+    std::size_t size_{0};
+};
+
+// ------------------------
+// ParseStats: outcome of a streaming decode
+// ------------------------
+struct ParseStats {
+    std::size_t events = 0;    // events handed to the sink
+    std::size_t skipped = 0;   // malformed lines / unknown messages
+};
+
+namespace detail {
+
+// Returns the first position in [p, end) holding `c`, or `end`.
+inline const char* find_char(const char* p, const char* end, char c) noexcept
+{
+#if defined(__SSE2__)
+    const __m128i vc = _mm_set1_epi8(c);
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, vc));
+        if (mask != 0)
+            return p + __builtin_ctz(static_cast<unsigned>(mask));
+        p += 16;
+    }
+#endif
+    while (p != end && *p != c) ++p;
+    return p;
+}
+
+template<typename T>
+inline bool parse_int(std::string_view field, T& out) noexcept
+{
+    auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), out);
+    return ec == std::errc{} && ptr == field.data() + field.size();
+}
+
+inline bool parse_event_type(std::string_view field, EventType& out) noexcept
+{
+    if (field.empty()) return false;
+    switch (field.front()) {
+        case 'L': case 'l': out = EventType::LIMIT;  return true;
+        case 'C': case 'c': out = EventType::CANCEL; return true;
+        case 'M': case 'm': out = EventType::MODIFY; return true;
+        default: return false;
+    }
+}
+
+inline bool parse_side(std::string_view field, Side& out) noexcept
+{
+    if (field.empty()) return false;
+    switch (field.front()) {
+        case 'B': case 'b': out = Side::Buy;  return true;
+        case 'S': case 's': out = Side::Sell; return true;
+        default: return false;
+    }
+}
+
+inline uint16_t load_be16(const unsigned char* p) noexcept
+{
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+inline uint32_t load_be32(const unsigned char* p) noexcept
+{
+    return (uint32_t{p[0]} << 24) | (uint32_t{p[1]} << 16) | (uint32_t{p[2]} << 8) | uint32_t{p[3]};
+}
+
+inline uint64_t load_be48(const unsigned char* p) noexcept
+{
+    uint64_t v = 0;
+    for (int i = 0; i < 6; ++i) v = (v << 8) | p[i];
+    return v;
+}
+
+inline uint64_t load_be64(const unsigned char* p) noexcept
+{
+    return (uint64_t{load_be32(p)} << 32) | load_be32(p + 4);
+}
+
+} // namespace detail
+
+// ------------------------
+// CSV decoder
+// ------------------------
+// One event per line, columns in HistoricalEvent order:
+//
+//     id,type,order_id,side,price,qty,ts[,participant]
+//
+// `type` is LIMIT/CANCEL/MODIFY (first letter is enough), `side` is B/S or
+// BUY/SELL. The participant column is optional: rows without it (or with
+// it empty) are anonymous. A leading header line and '\r' line endings are
+// tolerated. Each decoded event is passed to `sink(const HistoricalEvent&)`;
+// nothing is buffered.
+template<typename Sink>
+ParseStats for_each_csv_event(std::string_view data, Sink&& sink)
+{
+    ParseStats stats;
+
+    const char* p = data.data();
+    const char* const end = p + data.size();
+    bool first_line = true;
+
+    while (p < end) {
+        const char* eol = detail::find_char(p, end, '\n');
+        const char* line_end = (eol != p && eol[-1] == '\r') ? eol - 1 : eol;
+
+        if (line_end != p) {
+            std::string_view fields[8];
+            std::size_t n = 0;
+            const char* f = p;
+            bool extra = false;   // more than 8 columns
+            for (;;) {
+                const char* comma = detail::find_char(f, line_end, ',');
+                fields[n++] = std::string_view(f, static_cast<std::size_t>(comma - f));
+                if (comma == line_end) break;
+                if (n == 8) {
+                    extra = true;
+                    break;
+                }
+                f = comma + 1;
+            }
+
+            HistoricalEvent e{};
+            bool ok = !extra && (n == 7 || n == 8)
+                && detail::parse_int(fields[0], e.id)
+                && detail::parse_event_type(fields[1], e.type)
+                && detail::parse_int(fields[2], e.order_id)
+                && detail::parse_side(fields[3], e.side)
+                && detail::parse_int(fields[4], e.price)
+                && detail::parse_int(fields[5], e.qty)
+                && detail::parse_int(fields[6], e.ts)
+                && (n == 7 || fields[7].empty() || detail::parse_int(fields[7], e.participant));
+
+            if (ok) {
+                sink(static_cast<const HistoricalEvent&>(e));
+                ++stats.events;
+            } else {
+                // A leading header line is not counted as malformed
+                bool header = first_line && !fields[0].empty()
+                    && (fields[0].front() < '0' || fields[0].front() > '9');
+                if (!header) ++stats.skipped;
+            }
+            first_line = false;
+        }
+
+        p = (eol == end) ? end : eol + 1;
+    }
+
+    return stats;
+}
+
+// ------------------------
+// NASDAQ TotalView-ITCH 5.0 decoder
+// ------------------------
+// Input is the standard binary file layout: every message is preceded by a
+// 2-byte big-endian length. Order messages are mapped onto EventType:
+//
+//     A / F  Add Order              -> LIMIT
+//     E / C  Order Executed         -> MODIFY (size-down) or CANCEL when filled
+//     X      Order Cancel           -> MODIFY (size-down) or CANCEL when empty
+//     D      Order Delete           -> CANCEL
+//     U      Order Replace          -> CANCEL (old ref) + LIMIT (new ref)
+//
+// Prices are kept in native ITCH units (1/10000) as ticks. All other
+// message types are skipped. The decoder keeps the side, price and open
+// shares of every live order so that partial executions/cancels can be
+// expressed as MODIFY events with the new open quantity. A non-zero
+// `stock_locate` restricts decoding to a single instrument.
+//
+// Live-order nodes come from a NodePool over `upstream`: a deleted order's
+// node is reused by a later Add, so a warmed-up decoder stops allocating.
+class ItchDecoder {
+public:
+    explicit ItchDecoder(uint16_t stock_locate = 0,
+                         std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : nodes_(upstream), live_(&nodes_), stock_locate_(stock_locate) {}
+
+    template<typename Sink>
+    ParseStats decode(std::string_view data, Sink&& sink);
+
+    std::size_t live_orders() const noexcept { return live_.size(); }
+
+private:
+    struct LiveOrder {
+        Side side;
+        Price price;
+        Quantity remaining;
+    };
+
+    template<typename Sink>
+    void emit(Sink& sink, EventType type, OrderId ref, Side side, Price price,
+              Quantity qty, Timestamp ts, ParseStats& stats)
+    {
+        HistoricalEvent e{next_event_id_++, type, ref, side, price, qty, ts};
+        sink(static_cast<const HistoricalEvent&>(e));
+        ++stats.events;
+    }
+
+    template<typename Sink>
+    void reduce(Sink& sink, OrderId ref, Quantity shares, Timestamp ts, ParseStats& stats)
+    {
+        auto it = live_.find(ref);
+        if (it == live_.end()) {
+            ++stats.skipped;
+            return;
+        }
+        LiveOrder& lo = it->second;
+        lo.remaining -= shares;
+        if (lo.remaining <= 0) {
+            emit(sink, EventType::CANCEL, ref, lo.side, lo.price, 0, ts, stats);
+            live_.erase(it);
+        } else {
+            emit(sink, EventType::MODIFY, ref, lo.side, lo.price, lo.remaining, ts, stats);
+        }
+    }
+
+    NodePool nodes_;
+    std::pmr::unordered_map<OrderId, LiveOrder> live_;
+    EventId next_event_id_{1};
+    uint16_t stock_locate_{0};
+};
+
+template<typename Sink>
+ParseStats ItchDecoder::decode(std::string_view data, Sink&& sink)
+{
+    using detail::load_be16;
+    using detail::load_be32;
+    using detail::load_be48;
+    using detail::load_be64;
+
+    ParseStats stats;
+
+    const auto* p = reinterpret_cast<const unsigned char*>(data.data());
+    const auto* const end = p + data.size();
+
+    while (end - p >= 2) {
+        const std::size_t len = load_be16(p);
+        p += 2;
+        if (static_cast<std::size_t>(end - p) < len) break;   // truncated tail
+
+        const unsigned char* m = p;
+        p += len;
+        if (len < 11) {
+            ++stats.skipped;
+            continue;
+        }
+
+        // Common header: type(1) locate(2) tracking(2) timestamp(6)
+        if (stock_locate_ != 0 && load_be16(m + 1) != stock_locate_)
+            continue;
+        const auto ts = static_cast<Timestamp>(load_be48(m + 5));
+
+        switch (m[0]) {
+            case 'A':
+            case 'F': {
+                if (len < 36) { ++stats.skipped; break; }
+                const OrderId ref = load_be64(m + 11);
+                const Side side = (m[19] == 'B') ? Side::Buy : Side::Sell;
+                const auto shares = static_cast<Quantity>(load_be32(m + 20));
+                const auto price = static_cast<Price>(load_be32(m + 32));
+                live_[ref] = LiveOrder{side, price, shares};
+                emit(sink, EventType::LIMIT, ref, side, price, shares, ts, stats);
+                break;
+            }
+            case 'E':
+            case 'C': {
+                if (len < 31) { ++stats.skipped; break; }
+                reduce(sink, load_be64(m + 11), static_cast<Quantity>(load_be32(m + 19)), ts, stats);
+                break;
+            }
+            case 'X': {
+                if (len < 23) { ++stats.skipped; break; }
+                reduce(sink, load_be64(m + 11), static_cast<Quantity>(load_be32(m + 19)), ts, stats);
+                break;
+            }
+            case 'D': {
+                if (len < 19) { ++stats.skipped; break; }
+                const OrderId ref = load_be64(m + 11);
+                auto it = live_.find(ref);
+                if (it == live_.end()) { ++stats.skipped; break; }
+                emit(sink, EventType::CANCEL, ref, it->second.side, it->second.price, 0, ts, stats);
+                live_.erase(it);
+                break;
+            }
+            case 'U': {
+                if (len < 35) { ++stats.skipped; break; }
+                const OrderId old_ref = load_be64(m + 11);
+                const OrderId new_ref = load_be64(m + 19);
+                const auto shares = static_cast<Quantity>(load_be32(m + 27));
+                const auto price = static_cast<Price>(load_be32(m + 31));
+                auto it = live_.find(old_ref);
+                if (it == live_.end()) { ++stats.skipped; break; }
+                const Side side = it->second.side;
+                emit(sink, EventType::CANCEL, old_ref, side, it->second.price, 0, ts, stats);
+                live_.erase(it);
+                live_[new_ref] = LiveOrder{side, price, shares};
+                emit(sink, EventType::LIMIT, new_ref, side, price, shares, ts, stats);
+                break;
+            }
+            default:
+                // System, directory, trade and imbalance messages carry no book changes
+                break;
+        }
+    }
+
+    return stats;
+}
+
+template<typename Sink>
+ParseStats for_each_itch_event(std::string_view data, Sink&& sink, uint16_t stock_locate = 0)
+{
+    ItchDecoder decoder(stock_locate);
+    return decoder.decode(data, sink);
+}
+
+// ------------------------
+// File helpers: mmap + stream straight into the sink
+// ------------------------
+template<typename Sink>
+ParseStats load_csv_file(const std::string& path, Sink&& sink)
+{
+    MappedFile file(path);
+    if (!file.is_open()) return {};
+    return for_each_csv_event(file.view(), sink);
+}
+
+template<typename Sink>
+ParseStats load_itch_file(const std::string& path, Sink&& sink, uint16_t stock_locate = 0)
+{
+    MappedFile file(path);
+    if (!file.is_open()) return {};
+    return for_each_itch_event(file.view(), sink, stock_locate);
+}
+
+/* USAGE: Stream a vendor file into replay without an intermediate vector
+    lob::PaperTradingEngine paper(1 << 20);
+    lob::load_itch_file("01302019.NASDAQ_ITCH50", [&](const lob::HistoricalEvent& e) {
+        paper.feed_event(e);
+    }, stock_locate);
+*/
+
+} // namespace lob
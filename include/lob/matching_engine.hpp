@@ -1,6 +1,10 @@
 #pragma once
 #include "order_book.hpp"
 #include "perf_snapshots.hpp"
+#include "risk_engine.hpp"
+#include <concepts>
+#include <memory>
+#include <memory_resource>
 #include <vector>
 #include <chrono>
 #include <algorithm>
@@ -15,13 +19,105 @@ struct TradeEvent {
     Timestamp ts;
 };
 
+// Trade output buffers; allocate from whatever resource the owner chose
+using TradeBuffer = std::pmr::vector<TradeEvent>;
+
+// Caller-owned trade output: a plain vector or a TradeBuffer
+template<typename B>
+concept TradeSink = std::same_as<B, std::vector<TradeEvent>> || std::same_as<B, TradeBuffer>;
+
+// What to do when an incoming order would trade with a resting order of
+// the same participant
+enum class SelfTradePrevention : uint8_t {
+    None,           // allow self-trades
+    CancelNewest,   // cancel the remainder of the incoming order
+    CancelOldest,   // cancel the resting order and keep matching
+    DecrementBoth   // reduce both by the overlapping quantity, no trade
+};
+
+enum class MatchingMode : uint8_t {
+    Continuous,   // match on arrival
+    Auction       // accumulate without matching until uncross()
+};
+
+// Auction equilibrium: the price that maximises executable volume, then
+// minimises the surplus left at that price
+struct AuctionEquilibrium {
+    bool crossed{false};       // false: nothing executable, other fields are 0
+    Price price{0};
+    Quantity volume{0};        // executable at `price`
+    Quantity imbalance{0};     // bid surplus (> 0) or ask surplus (< 0) at `price`
+};
+
 class MatchingEngine {
 public:
-    explicit MatchingEngine(std::size_t pool_size);
+    // Latency samples kept by `perf` (the most recent accepted orders,
+    // auction rests included); allocated up front so recording never allocates
+    static constexpr std::size_t kLatencyWindow = 1 << 16;
+
+    // `mr` backs the book's levels and index and the latency samples
+    explicit MatchingEngine(std::size_t pool_size,
+                            std::pmr::memory_resource* mr = std::pmr::get_default_resource());
 
     // Main entry point
     std::vector<TradeEvent> match_limit_order(Order* incoming);
 
+    // Same, appending trades to a caller-owned buffer (no per-call allocation).
+    // With risk checks enabled a rejected order goes back to the pool and
+    // never reaches the book; submit_limit_order reports why.
+    template<TradeSink B>
+    void match_limit_order(Order* incoming, B& events);
+
+    // Checked entry point: match_limit_order that returns the risk verdict
+    // (always Accepted while risk checks are off)
+    template<TradeSink B>
+    RiskResult submit_limit_order(Order* incoming, B& events);
+
+    // Modify a resting order. Same-price size-downs are applied in place
+    // (priority kept, no map work); a requeue only goes through the matcher
+    // when the new price crosses the opposite side. False if the order is
+    // unknown or the modify fails risk checks (the order is left as it was).
+    template<TradeSink B>
+    bool modify_order(OrderId id, Price new_price, Quantity new_qty, Timestamp ts, B& events);
+
+    // ----------------------
+    // Call auction
+    // ----------------------
+    // In Auction mode incoming orders rest without matching. indicative()
+    // is a linear pass over the crossed levels only, so it is cheap enough
+    // to publish after every order. uncross() executes the whole
+    // equilibrium volume at one price in price-time priority.
+    void set_mode(MatchingMode mode) noexcept { mode_ = mode; }
+    MatchingMode mode() const noexcept { return mode_; }
+
+    AuctionEquilibrium indicative() const;
+
+    std::vector<TradeEvent> uncross(Timestamp ts);
+
+    template<TradeSink B>
+    void uncross(Timestamp ts, B& events);
+
+    void set_self_trade_prevention(SelfTradePrevention mode) noexcept { stp_ = mode; }
+    SelfTradePrevention self_trade_prevention() const noexcept { return stp_; }
+
+    // ----------------------
+    // Pre-trade risk
+    // ----------------------
+    // Off by default. Once enabled, orders and risk-increasing modifies
+    // from non-anonymous owners are checked inline, and pending kill
+    // switches are applied at the start of every command.
+    RiskEngine& enable_risk_checks(std::size_t max_accounts);
+
+    // Engine thread: flatten accounts killed since the last command without
+    // waiting for one. Replay loops call this once per event (and while
+    // idle); cheap unless a kill is pending. Returns orders cancelled.
+    std::size_t poll_risk()
+    {
+        return risk_ ? risk_->apply_kills() : 0;
+    }
+    RiskEngine* risk() noexcept { return risk_.get(); }
+    const RiskEngine* risk() const noexcept { return risk_.get(); }
+
     // Access book for analytics
     OrderBook& book() noexcept { return book_; }
     const OrderBook& book() const noexcept { return book_; }
@@ -32,7 +128,21 @@ public:
     PerfStats perf;
 
 private:
+    // Route an accepted order: rest (auction) or match, timed into perf
+    template<TradeSink B>
+    void execute(Order* incoming, B& events);
+
+    // Matcher for an incoming order on side S; instantiated once per side
+    // and buffer type
+    template<Side S, TradeSink B>
+    void match(Order* incoming, B& events);
+
     OrderBook book_;
+    SelfTradePrevention stp_{SelfTradePrevention::None};
+    MatchingMode mode_{MatchingMode::Continuous};
+    std::unique_ptr<RiskEngine> risk_;
+
+    TradeBuffer scratch_;   // by-value entry points match into this first
 };
 
 } // namespace lob
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <memory_resource>
 #include <vector>
 #include "order.hpp"
 
@@ -10,9 +12,12 @@ class OrderPool {
     size_t dealloc_count = 0;
 
 public:
-    explicit OrderPool(std::size_t capacity)
+    explicit OrderPool(std::size_t capacity,
+                       std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : storage_(mr), free_list_(mr)
     {
         storage_.resize(capacity);
+        free_list_.reserve(capacity);
 
         // Build free list
         for (std::size_t i = 0; i < capacity; ++i) {
@@ -28,6 +33,7 @@ public:
         Order* o = free_list_.back();
         free_list_.pop_back();
         ++alloc_count;
+        *o = Order{};   // no stale links or flags from the previous owner
         return o;
     }
 
@@ -40,8 +46,8 @@ public:
     size_t active() const { return alloc_count - dealloc_count; }
 
 private:
-    std::vector<Order> storage_;
-    std::vector<Order*> free_list_;
+    std::pmr::vector<Order> storage_;
+    std::pmr::vector<Order*> free_list_;
 };
 
 } // namespace lob
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+
+namespace lob {
+
+// ------------------------
+// CountingResource: allocation statistics for an upstream resource
+// ------------------------
+// Sits between a container (or another resource) and its upstream and
+// counts what passes through. Wrap the upstream of a NodePool to see how
+// often the pool itself has to go to the system allocator.
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream) {}
+
+    std::size_t allocations() const noexcept { return allocations_.load(std::memory_order_relaxed); }
+    std::size_t deallocations() const noexcept { return deallocations_.load(std::memory_order_relaxed); }
+    std::size_t bytes_allocated() const noexcept { return bytes_.load(std::memory_order_relaxed); }
+
+    // Start a new measurement window (e.g. after warm-up)
+    void reset() noexcept
+    {
+        allocations_.store(0, std::memory_order_relaxed);
+        deallocations_.store(0, std::memory_order_relaxed);
+        bytes_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        bytes_.fetch_add(bytes, std::memory_order_relaxed);
+        return upstream_->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        deallocations_.fetch_add(1, std::memory_order_relaxed);
+        upstream_->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* upstream_;
+    std::atomic<std::size_t> allocations_{0};
+    std::atomic<std::size_t> deallocations_{0};
+    std::atomic<std::size_t> bytes_{0};
+};
+
+// ------------------------
+// NodePool: level, index and participant nodes of one book
+// ------------------------
+// Map and hash nodes are a handful of fixed sizes; freed nodes go back to
+// their size class and are reused, so a warmed-up book stops calling
+// upstream. Not thread-safe: one book, one matching thread.
+class NodePool : public std::pmr::unsynchronized_pool_resource {
+public:
+    explicit NodePool(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : std::pmr::unsynchronized_pool_resource(options(), upstream) {}
+
+private:
+    static std::pmr::pool_options options() noexcept
+    {
+        std::pmr::pool_options opts;
+        opts.max_blocks_per_chunk        = 4096;
+        opts.largest_required_pool_block = 256;   // bigger blocks (bucket arrays) go upstream
+        return opts;
+    }
+};
+
+// ------------------------
+// ReplayArena: per-replay output (trades, analytics)
+// ------------------------
+// Bump allocation, nothing freed until release(); call it between runs.
+// Vector growth leaves the old blocks behind, so reserve() when the event
+// count is known.
+class ReplayArena : public std::pmr::monotonic_buffer_resource {
+public:
+    explicit ReplayArena(std::size_t initial_bytes = 1 << 20,
+                         std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : std::pmr::monotonic_buffer_resource(initial_bytes, upstream) {}
+};
+
+/* USAGE: One pooled book, per-run arena, allocation audit
+    lob::CountingResource counter;
+    lob::NodePool nodes(&counter);
+    lob::ReplayArena arena;
+
+    lob::MatchingEngine engine(1 << 20, &nodes);   // latency window preallocated in `nodes`
+    lob::PaperTradingEngine paper(engine);
+
+    lob::TradeBuffer trades(&arena);
+    lob::AnalyticsBuffer analytics(&arena);
+    paper.feed_events(warm_up, trades, analytics);
+    counter.reset();
+    paper.feed_events(session, trades, analytics);   // counter.allocations() == 0 once warm
+    // ... consume, destroy the buffers, then arena.release()
+*/
+
+} // namespace lob
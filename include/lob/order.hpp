@@ -3,14 +3,31 @@
 #include "types.hpp"
 #include "side.hpp"
 
+struct PriceLevel;
+namespace lob { struct ParticipantState; }
+
 struct Order {
     OrderId   id;
     Price     price;
     Quantity  qty;
     Quantity  remaining;
     Side      side;
+    bool      tracked;       // maintain queue position (see OrderBook::queue_position)
+    ParticipantId owner;     // 0 = anonymous (no accounting, no self-trade checks)
     Timestamp ts;
 
     Order* next;   // intrusive linked list
     Order* prev;
+    PriceLevel* level;   // owning level while resting (map nodes are stable)
+
+    // Queue position, only maintained while `tracked`
+    uint64_t  seq;           // insertion sequence; lower = earlier in its level
+    uint64_t  orders_ahead;
+    Quantity  volume_ahead;
+    Order*    next_tracked;  // tracked orders at the same level
+
+    // Per-participant intrusive list, only linked when `owner` != 0
+    lob::ParticipantState* account;
+    Order*    owner_next;
+    Order*    owner_prev;
 };
\ No newline at end of file
@@ -1,28 +1,86 @@
 #pragma once
 
+#include <functional>
 #include <map>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
 #include <unordered_map>
 #include "types.hpp"
 #include "side.hpp"
 #include "order.hpp"
 #include "price_level.hpp"
+#include "book_side.hpp"
 #include "memory_pool.hpp"
+#include "depth_index.hpp"
+#include "order_index.hpp"
 
 namespace lob {
 
+// Open orders and exposure of one participant, maintained incrementally
+struct ParticipantState {
+    std::size_t open_orders{0};
+    Quantity open_buy_qty{0};
+    Quantity open_sell_qty{0};
+    Quantity open_notional{0};   // sum of price * remaining
+
+    Order* head{nullptr};        // intrusive list of this participant's orders
+};
+
+// Called after the best level of `side` changes price or size
+using TopOfBookListener = std::function<void(Side side)>;
+
+struct QueuePosition {
+    std::size_t orders_ahead;
+    Quantity volume_ahead;
+};
+
 class OrderBook {
 public:
-    explicit OrderBook(std::size_t pool_size);
+    // Best price first on both sides: begin() is the touch
+    using BidLevels = BidSide::Levels;
+    using AskLevels = AskSide::Levels;
+
+    // Every internal container (levels, id index, participants, the order
+    // pool itself) allocates from `mr`. The index is sized for `pool_size`
+    // orders up front, so it never rehashes while the pool has room.
+    explicit OrderBook(std::size_t pool_size,
+                       std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+
+    std::pmr::memory_resource* resource() const noexcept { return order_index_.get_allocator().resource(); }
 
     Order* add_limit_order_no_match(
         OrderId id,
         Side side,
         Price price,
         Quantity qty,
-        Timestamp ts
+        Timestamp ts,
+        ParticipantId owner = 0
     );
 
     bool cancel_order(OrderId id);
+
+    // Cancel every open order of `owner` in O(own orders); returns the count
+    std::size_t cancel_participant(ParticipantId owner);
+
+    // ---- Bulk cancels: whole levels are detached at once; return the count ----
+    // Each cancelled order is still visited once to release its pool slot,
+    // account link and index entry. The visits overlap across levels, so
+    // this runs ~2x faster than a cancel_order loop, and ~3x when the
+    // whole book goes and the index is cleared in one pass. It is not an
+    // order of magnitude faster.
+
+    std::size_t cancel_side(Side side);
+
+    // Bids priced <= `price`, or asks priced >= `price` (the touch and
+    // everything behind it from `price` outwards)
+    std::size_t cancel_at_or_beyond(Side side, Price price);
+
+    std::size_t cancel_orders(std::span<const OrderId> ids);
+    // `new_qty` is the new open quantity. A same-price size-down is applied
+    // in place and keeps queue priority; anything else requeues at the
+    // tail of the (new) level. Does not match: see MatchingEngine::modify_order.
     bool modify_order(OrderId id, Price new_price, Quantity new_qty);
 
     const PriceLevel* best_bid() const;
@@ -30,32 +88,142 @@ public:
 
     std::size_t size() const noexcept;
 
+    // Resting volume across both sides, maintained incrementally
+    Quantity total_volume() const noexcept { return total_volume_; }
+
+    // O(1) queue position of a tracked order. Orders are tracked when they
+    // enter a level with `tracked` set, or after track_queue (one walk).
+    std::optional<QueuePosition> queue_position(OrderId id) const;
+    bool track_queue(OrderId id);
+
+    // nullptr until the participant has rested an order (or is registered)
+    const ParticipantState* participant(ParticipantId owner) const;
+
+    // Create the participant's state ahead of its first order; the
+    // reference stays valid for the book's lifetime
+    ParticipantState& register_participant(ParticipantId owner) { return participants_[owner]; }
+
+    // Maintain a cumulative depth index over [lo, hi] from now on (seeded
+    // from the current levels). Off by default: it costs two tree updates
+    // per level-volume change.
+    void enable_depth_index(Price lo, Price hi);
+    const DepthIndex* depth_index() const noexcept { return depth_.get(); }
+
+    // One listener per book; empty to detach. A ConsolidatedBook chains
+    // to whatever listener is already set.
+    void set_top_of_book_listener(TopOfBookListener listener) { top_listener_ = std::move(listener); }
+    const TopOfBookListener& top_of_book_listener() const noexcept { return top_listener_; }
+
     /*auto& bids() noexcept { return bids_; }
     auto& asks() noexcept { return asks_; }
 
     const auto& bids() const noexcept { return bids_; }
     const auto& asks() const noexcept { return asks_; }*/
 
-    std::map<Price, PriceLevel>& asks() { return asks_; }
-    std::map<Price, PriceLevel>& bids() { return bids_; }
+    AskLevels& asks() { return asks_; }
+    BidLevels& bids() { return bids_; }
+
+    const AskLevels& asks() const { return asks_; }
+    const BidLevels& bids() const { return bids_; }
+
+    // Levels of side S, resolved at compile time
+    template<Side S>
+    typename BookSide<S>::Levels& levels() noexcept
+    {
+        if constexpr (S == Side::Buy) return bids_; else return asks_;
+    }
+
+    template<Side S>
+    const typename BookSide<S>::Levels& levels() const noexcept
+    {
+        if constexpr (S == Side::Buy) return bids_; else return asks_;
+    }
 
     OrderPool& pool() noexcept { return pool_; }
     const OrderPool& pool() const noexcept { return pool_; }
 
-    void remove_from_level(Order* order);
-    void insert_into_level(Order* order);
+    void remove_from_level(Order* order)
+    {
+        if (order && order->side == Side::Buy) remove_from_level<Side::Buy>(order);
+        else remove_from_level<Side::Sell>(order);
+    }
+
+    void insert_into_level(Order* order)
+    {
+        if (order->side == Side::Buy) insert_into_level<Side::Buy>(order);
+        else insert_into_level<Side::Sell>(order);
+    }
+
+    // Side-specialised forms for callers that already know the side
+    // (instantiated for both sides in order_book.cpp)
+    template<Side S> void remove_from_level(Order* order);
+    template<Side S> void insert_into_level(Order* order);
+
+    // Shrink a resting order in place, keeping its queue position
+    void reduce_order(Order* order, Quantity qty) noexcept
+    {
+        on_fill(*order->level, order, qty);
+    }
+
+    // Execute `qty` against a resting order without unlinking it
+    void on_fill(PriceLevel& level, Order* resting, Quantity qty) noexcept
+    {
+        resting->remaining -= qty;
+        level.total_volume -= qty;
+        total_volume_      -= qty;
+        if (depth_) depth_->add(resting->side, level.price, -qty);
+        if (top_listener_ && is_top(resting->side, level)) top_listener_(resting->side);
+        if (level.tracked_head) release_queue_ahead(level, resting, qty, 0);
+        if (resting->account) release_exposure(*resting->account, resting, qty);
+    }
 
     auto& order_index() noexcept { return order_index_; }
     const auto& order_index() const noexcept { return order_index_; }
 
 private:
-    using AskLevels = std::map<Price, PriceLevel, std::less<Price>>;
-    using BidLevels = std::map<Price, PriceLevel, std::less<Price>>;
+    bool is_top(Side side, const PriceLevel& level) const noexcept
+    {
+        return side == Side::Buy ? &bids_.begin()->second == &level
+                                 : &asks_.begin()->second == &level;
+    }
+
+    // Credit tracked orders queued behind `order` with `qty` / `orders`
+    // leaving the level; unlinks `order` from the tracked list if it leaves.
+    void release_queue_ahead(PriceLevel& level, const Order* order, Quantity qty, std::size_t orders) noexcept;
+
+    static void release_exposure(ParticipantState& account, const Order* order, Quantity qty) noexcept
+    {
+        if (order->side == Side::Buy) {
+            account.open_buy_qty -= qty;
+        } else {
+            account.open_sell_qty -= qty;
+        }
+        account.open_notional -= order->price * qty;
+    }
+
+    // Drop levels [first, last) of one side without per-order map work
+    template<typename Levels>
+    std::size_t release_levels(Side side, Levels& levels, typename Levels::iterator first,
+                               typename Levels::iterator last);
+
+    void link_participant(Order* order);
+    void unlink_participant(Order* order) noexcept;
 
     BidLevels bids_;
     AskLevels asks_;
 
-    std::unordered_map<OrderId, Order*> order_index_;
+    OrderIndex order_index_;
+
+    // Node-based, so Order::account pointers stay valid
+    std::pmr::unordered_map<ParticipantId, ParticipantState> participants_;
+
+    std::pmr::vector<Order*> scratch_;   // cancel_orders working set
+
+    Quantity total_volume_{0};
+    uint64_t next_seq_{0};
+
+    std::unique_ptr<DepthIndex> depth_;
+    TopOfBookListener top_listener_;
 
     OrderPool pool_;
 };
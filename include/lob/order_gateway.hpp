@@ -0,0 +1,136 @@
+#pragma once
+#include "matching_engine.hpp"
+#include "replay.hpp"
+#include <algorithm>
+#include <memory_resource>
+#include <optional>
+#include <queue>
+#include <span>
+#include <vector>
+
+namespace lob {
+
+// How strategy orders meet the market
+enum class GatewayMode : uint8_t {
+    Live,     // orders enter the engine's book and match there
+    Shadow,   // orders stay in the gateway; fills are inferred from the book
+};
+
+// ------------------------
+// OrderGateway: strategy order entry with simulated latency
+// ------------------------
+// Strategy orders and cancels are stamped with `now + latency` and held in
+// a time-ordered queue. The replay merges them with the historical stream:
+// before an event at time T is applied, every command that arrived strictly
+// before T reaches the engine (ties go to the historical event). Strategy
+// orders are queue-tracked, so their position is an O(1) lookup.
+//
+// In Shadow mode the book is a market replayed for many followers and is
+// never modified; orders live in the gateway and have no market impact:
+// - on arrival an order takes the visible liquidity that crosses it
+//   (left in place), and the rest joins the back of its level's queue
+// - prints at its price then eat the volume ahead of it before filling
+//   it, and prints through its price fill it first
+// - an incoming order left resting through its price fills it
+// - cancels on its level shrink the volume ahead to at most the level
+// on_market_event advances this after each market event; queue_position
+// reports the volume ahead (orders_ahead is not modelled and stays 0).
+class OrderGateway {
+public:
+    // Strategy order ids live in the upper half of the id space
+    static constexpr OrderId kFirstOrderId = OrderId{1} << 63;
+
+    static constexpr bool is_strategy_order(OrderId id) noexcept { return id >= kFirstOrderId; }
+
+    // In-flight commands live on `mr` (default: the engine's book resource)
+    explicit OrderGateway(MatchingEngine& engine, std::pmr::memory_resource* mr = nullptr)
+        : engine_(engine),
+          pending_(LaterArrival{}, std::pmr::vector<Command>(mr ? mr : engine.book().resource())),
+          shadow_(mr ? mr : engine.book().resource()) {}
+
+    // Set before the first order
+    void set_mode(GatewayMode mode) noexcept { mode_ = mode; }
+    GatewayMode mode() const noexcept { return mode_; }
+
+    void set_latency(Timestamp latency) noexcept { latency_ = latency; }
+    Timestamp latency() const noexcept { return latency_; }
+
+    // Owner stamped on strategy orders (accounting, self-trade prevention)
+    void set_participant(ParticipantId owner) noexcept { owner_ = owner; }
+
+    // Replay clock: the timestamp of the event currently being processed
+    Timestamp now() const noexcept { return now_; }
+
+    // Returns the id the order will carry once it reaches the book
+    OrderId submit_limit(Side side, Price price, Quantity qty);
+    void cancel(OrderId id);
+
+    std::optional<QueuePosition> queue_position(OrderId id) const;
+
+    std::size_t pending() const noexcept { return pending_.size(); }
+
+    // Shadow mode: open orders held by the gateway
+    std::size_t shadow_orders() const noexcept { return shadow_.size(); }
+
+    // Advance the clock to `ts` and deliver commands that arrived before it
+    void advance_to(Timestamp ts, TradeBuffer& trades);
+
+    // Deliver everything still in flight (e.g. at the end of a replay)
+    void flush(TradeBuffer& trades);
+
+    // Shadow mode: settle open orders against market event `e`, already
+    // applied to the book with `market` as its trades; appends the fills
+    void on_market_event(const HistoricalEvent& e, std::span<const TradeEvent> market,
+                         TradeBuffer& fills);
+
+private:
+    struct Command {
+        enum class Kind : uint8_t { Submit, Cancel };
+
+        Timestamp arrival;
+        uint64_t  seq;       // submission order breaks arrival ties
+        Kind      kind;
+        OrderId   id;
+        Side      side;
+        Price     price;
+        Quantity  qty;
+    };
+
+    struct LaterArrival {
+        bool operator()(const Command& a, const Command& b) const noexcept {
+            return a.arrival != b.arrival ? a.arrival > b.arrival : a.seq > b.seq;
+        }
+    };
+
+    struct ShadowOrder {
+        OrderId  id;
+        Side     side;
+        Price    price;
+        Quantity remaining;
+        Quantity ahead;      // market volume queued in front at `price`
+    };
+
+    void execute(const Command& cmd, TradeBuffer& trades);
+    void shadow_submit(const Command& cmd, TradeBuffer& trades);
+
+    // First shadow order with id >= `id`; shadow_ is kept sorted by id
+    auto find_shadow(OrderId id) const
+    {
+        return std::lower_bound(shadow_.begin(), shadow_.end(), id,
+                                [](const ShadowOrder& s, OrderId key) { return s.id < key; });
+    }
+    Quantity level_volume(Side side, Price price) const;
+
+    MatchingEngine& engine_;
+    GatewayMode mode_{GatewayMode::Live};
+    Timestamp latency_{0};
+    Timestamp now_{0};
+    ParticipantId owner_{0};
+    uint64_t next_seq_{0};
+    OrderId next_id_{kFirstOrderId};
+
+    std::priority_queue<Command, std::pmr::vector<Command>, LaterArrival> pending_;
+    std::pmr::vector<ShadowOrder> shadow_;   // sorted by id: binary-searched
+};
+
+} // namespace lob
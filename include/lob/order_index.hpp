@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "types.hpp"
+#include "order.hpp"
+
+namespace lob {
+
+// ------------------------
+// OrderIndex: OrderId -> Order*, one flat open-addressed table
+// ------------------------
+// Linear probing over a power-of-two array of {id, order} slots; an empty
+// slot has a null order. Erase shifts the following run back instead of
+// leaving tombstones, so lookups never degrade. No per-entry allocation:
+// inserting and erasing only write slots, and clear() is one pass over the
+// array. The map-like subset the book uses (find/emplace/erase/at/count,
+// iteration over live entries) keeps existing callers unchanged.
+class OrderIndex {
+public:
+    struct Entry {
+        OrderId first{0};
+        Order* second{nullptr};
+    };
+
+    template<typename E>
+    class basic_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = Entry;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = E*;
+        using reference         = E&;
+
+        basic_iterator() = default;
+        basic_iterator(E* slot, E* end) noexcept : slot_(slot), end_(end) {}
+
+        // iterator -> const_iterator
+        template<typename F>
+            requires (!std::is_same_v<F, E>)
+        basic_iterator(const basic_iterator<F>& other) noexcept : slot_(other.slot_), end_(other.end_) {}
+
+        reference operator*() const noexcept { return *slot_; }
+        pointer operator->() const noexcept { return slot_; }
+
+        basic_iterator& operator++() noexcept
+        {
+            do { ++slot_; } while (slot_ != end_ && !slot_->second);
+            return *this;
+        }
+        basic_iterator operator++(int) noexcept { auto copy = *this; ++*this; return copy; }
+
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept { return a.slot_ == b.slot_; }
+
+    private:
+        template<typename> friend class basic_iterator;
+        friend class OrderIndex;
+
+        E* slot_{nullptr};
+        E* end_{nullptr};
+    };
+
+    using iterator       = basic_iterator<Entry>;
+    using const_iterator = basic_iterator<const Entry>;
+
+    explicit OrderIndex(std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : slots_(mr)
+    {
+        rehash(16);
+    }
+
+    std::pmr::polymorphic_allocator<Entry> get_allocator() const noexcept { return slots_.get_allocator(); }
+
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    // Room for `n` entries at <= 50% load without growing
+    void reserve(std::size_t n)
+    {
+        const std::size_t want = std::bit_ceil(std::max<std::size_t>(2 * n, 16));
+        if (want > slots_.size()) rehash(want);
+    }
+
+    iterator begin() noexcept { return skip(iterator{slots_.data(), slots_.data() + slots_.size()}); }
+    iterator end() noexcept { return {slots_.data() + slots_.size(), slots_.data() + slots_.size()}; }
+    const_iterator begin() const noexcept { return skip(const_iterator{slots_.data(), slots_.data() + slots_.size()}); }
+    const_iterator end() const noexcept { return {slots_.data() + slots_.size(), slots_.data() + slots_.size()}; }
+
+    iterator find(OrderId id) noexcept
+    {
+        const std::size_t i = probe(id);
+        return slots_[i].second ? iterator{&slots_[i], slots_.data() + slots_.size()} : end();
+    }
+
+    const_iterator find(OrderId id) const noexcept
+    {
+        const std::size_t i = probe(id);
+        return slots_[i].second ? const_iterator{&slots_[i], slots_.data() + slots_.size()} : end();
+    }
+
+    std::size_t count(OrderId id) const noexcept { return slots_[probe(id)].second ? 1 : 0; }
+
+    Order* at(OrderId id) const
+    {
+        Order* o = slots_[probe(id)].second;
+        if (!o) throw std::out_of_range("OrderIndex::at");
+        return o;
+    }
+
+    // Like unordered_map::emplace: an existing id is left untouched
+    std::pair<iterator, bool> emplace(OrderId id, Order* order)
+    {
+        if (2 * (size_ + 1) > slots_.size()) rehash(2 * slots_.size());
+
+        const std::size_t i = probe(id);
+        Entry* slot = &slots_[i];
+        if (slot->second) return {iterator{slot, slots_.data() + slots_.size()}, false};
+
+        *slot = Entry{id, order};
+        ++size_;
+        return {iterator{slot, slots_.data() + slots_.size()}, true};
+    }
+
+    void erase(iterator it) noexcept { erase_slot(static_cast<std::size_t>(it.slot_ - slots_.data())); }
+
+    std::size_t erase(OrderId id) noexcept
+    {
+        const std::size_t i = probe(id);
+        if (!slots_[i].second) return 0;
+        erase_slot(i);
+        return 1;
+    }
+
+    // Warm the home slot of `id` ahead of a batch of erases / lookups
+    void prefetch(OrderId id) const noexcept { __builtin_prefetch(&slots_[home(id)]); }
+
+    void clear() noexcept
+    {
+        if (size_ == 0) return;
+        std::fill(slots_.begin(), slots_.end(), Entry{});
+        size_ = 0;
+    }
+
+private:
+    std::size_t home(OrderId id) const noexcept
+    {
+        // Fibonacci hashing: dense and strided ids both spread over the table
+        return static_cast<std::size_t>((id * 0x9E3779B97F4A7C15ULL) >> shift_);
+    }
+
+    // Slot holding `id`, or the empty slot that ends its probe run
+    std::size_t probe(OrderId id) const noexcept
+    {
+        std::size_t i = home(id);
+        while (slots_[i].second && slots_[i].first != id) i = (i + 1) & mask_;
+        return i;
+    }
+
+    void erase_slot(std::size_t hole) noexcept
+    {
+        // Backward shift: pull later members of the run into the hole
+        // unless their home lies cyclically in (hole, j]
+        for (std::size_t j = (hole + 1) & mask_; slots_[j].second; j = (j + 1) & mask_) {
+            const std::size_t k = home(slots_[j].first);
+            const bool stays = (hole <= j) ? (hole < k && k <= j) : (hole < k || k <= j);
+            if (!stays) {
+                slots_[hole] = slots_[j];
+                hole = j;
+            }
+        }
+        slots_[hole] = Entry{};
+        --size_;
+    }
+
+    template<typename It>
+    static It skip(It it) noexcept
+    {
+        while (it.slot_ != it.end_ && !it.slot_->second) ++it.slot_;
+        return it;
+    }
+
+    void rehash(std::size_t capacity)
+    {
+        std::pmr::vector<Entry> old(capacity, slots_.get_allocator());
+        old.swap(slots_);
+        mask_  = capacity - 1;
+        shift_ = 64 - std::countr_zero(capacity);
+        size_  = 0;
+        for (const Entry& e : old) {
+            if (e.second) {
+                slots_[probe(e.first)] = e;
+                ++size_;
+            }
+        }
+    }
+
+    std::pmr::vector<Entry> slots_;
+    std::size_t size_{0};
+    std::size_t mask_{0};
+    int shift_{64};
+};
+
+} // namespace lob
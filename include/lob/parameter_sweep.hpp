@@ -0,0 +1,301 @@
+#pragma once
+#include "strategy_engine.hpp"
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <exception>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace lob {
+
+// Memory: each book costs ~168 B per pool slot (the Order, its free-list
+// entry and two 16 B index slots) plus a 512 KiB latency window, so
+// ~3 MiB at the default pool_size. Exact mode keeps one book per
+// instance (K = 500: ~1.5 GiB), shared_market one per worker.
+struct SweepOptions {
+    std::size_t pool_size{1 << 14};   // resting orders per book; size to the day's peak
+    std::size_t batch_events{0};      // 0: ~256 KiB of events, sized to stay in L2
+    std::size_t threads{0};           // 0: hardware concurrency (capped at the instance count)
+    bool keep_records{false};         // keep every instance's trades/snapshots
+    bool shared_market{false};        // one market book per worker, no market impact
+};
+
+// ------------------------
+// ParameterSweep: one decoded stream, K strategy instances
+// ------------------------
+// The calling thread decodes the source once into two alternating batch
+// buffers. Worker threads each own an interleaved slice of the instances
+// and replay every batch through all of them while the next batch is
+// being decoded. A std::barrier per batch hands the buffers over. Each
+// batch is read by every instance on a core while it is still in cache,
+// so K instances cost K matching passes but only one decode and one pass
+// over memory per worker.
+//
+// By default instances are independent StrategyEngine<S> objects with
+// their own book, so each one's orders move its market: exact, but K
+// books cost K full matching passes.
+//
+// With shared_market set, each worker matches the flow once on its own
+// market book and its instances follow that book, holding only their own
+// orders in a Shadow-mode OrderGateway (see there for the fill model).
+// Strategies see the same hooks, but their orders have no market impact,
+// and strategies with before_event are rejected. An instance then costs
+// its hooks and a few comparisons per event instead of a replay.
+//
+// Results stay in each instance: strategy state, and trades / analytics
+// when keep_records is set (only the strategy's own fills when shared).
+template<typename S>
+    requires Strategy<S> || GatewayHook<S>
+class ParameterSweep {
+public:
+    using Instance = StrategyEngine<S>;
+
+    // `make(i)` returns the strategy for instance i (e.g. built from params[i])
+    template<typename Factory>
+    ParameterSweep(std::size_t instances, Factory&& make, SweepOptions options = {})
+        : options_(options)
+    {
+        if (options_.batch_events == 0) {
+            options_.batch_events = std::max<std::size_t>(256, (256 * 1024) / sizeof(HistoricalEvent));
+        }
+        workers_ = worker_count(instances);
+
+        instances_.reserve(instances);
+        if (!options_.shared_market) {
+            for (std::size_t i = 0; i < instances; ++i) {
+                instances_.push_back(std::make_unique<Instance>(options_.pool_size, make(i)));
+            }
+            return;
+        }
+
+        if constexpr (PreEventHook<S>) {
+            throw std::invalid_argument("ParameterSweep: shared_market needs a strategy without before_event");
+        }
+        markets_.reserve(workers_);
+        for (std::size_t w = 0; w < workers_; ++w) {
+            markets_.push_back(std::make_unique<Market>(options_.pool_size));
+        }
+        // Instance i is replayed by worker i % workers
+        for (std::size_t i = 0; i < instances; ++i) {
+            instances_.push_back(std::make_unique<Instance>(markets_[i % workers_]->engine, make(i)));
+            instances_.back()->follow_market();
+        }
+    }
+
+    // Source: same contract as PipelinedReplay::run, source(sink) calls
+    // sink(const HistoricalEvent&) once per event
+    template<typename Source>
+    void run(Source&& source);
+
+    void run(std::span<const HistoricalEvent> events)
+    {
+        run([events](auto&& sink) {
+            for (const auto& e : events) sink(e);
+        });
+    }
+
+    void run(const std::vector<HistoricalEvent>& events)
+    {
+        run(std::span<const HistoricalEvent>(events));
+    }
+
+    std::size_t size() const noexcept { return instances_.size(); }
+    std::size_t workers() const noexcept { return workers_; }
+
+    // shared_market: events matched so far, summed over the worker books
+    // (each worker matches every event once, whatever its instance count)
+    std::size_t market_events() const noexcept
+    {
+        std::size_t n = 0;
+        for (const auto& m : markets_) n += m->events;
+        return n;
+    }
+
+    Instance& instance(std::size_t i) noexcept { return *instances_[i]; }
+    const Instance& instance(std::size_t i) const noexcept { return *instances_[i]; }
+
+    // f(instance) for every instance, in instance order
+    template<typename F>
+    auto collect(F&& f) const
+    {
+        std::vector<decltype(f(std::declval<const Instance&>()))> out;
+        out.reserve(instances_.size());
+        for (const auto& inst : instances_) out.push_back(f(*inst));
+        return out;
+    }
+
+private:
+    // One worker's market book and the trades of its current event
+    struct Market {
+        explicit Market(std::size_t pool_size) : engine(pool_size), trades(engine.book().resource()) {}
+
+        MatchingEngine engine;
+        TradeBuffer trades;
+        std::size_t events{0};
+    };
+
+    std::size_t worker_count(std::size_t instances) const noexcept
+    {
+        std::size_t n = options_.threads ? options_.threads : std::thread::hardware_concurrency();
+        return std::clamp<std::size_t>(n, 1, std::max<std::size_t>(instances, 1));
+    }
+
+    void replay_slice(std::size_t worker, std::size_t workers, std::span<const HistoricalEvent> batch)
+    {
+        if constexpr (!PreEventHook<S>) {
+            if (options_.shared_market) {
+                follow_slice(worker, workers, batch);
+                return;
+            }
+        }
+
+        for (std::size_t i = worker; i < instances_.size(); i += workers) {
+            Instance& inst = *instances_[i];
+            inst.feed_events(batch);
+            if (!options_.keep_records) {
+                inst.clear_records();
+                inst.engine().perf.clear();
+            }
+        }
+    }
+
+    // Shared market: match each event once, then step every follower
+    void follow_slice(std::size_t worker, std::size_t workers, std::span<const HistoricalEvent> batch)
+        requires (!PreEventHook<S>)
+    {
+        Market& market = *markets_[worker];
+        for (const auto& e : batch) {
+            for (std::size_t i = worker; i < instances_.size(); i += workers) {
+                instances_[i]->before_market_event(e);
+            }
+            market.trades.clear();
+            apply_event(market.engine, e, market.trades);
+            for (std::size_t i = worker; i < instances_.size(); i += workers) {
+                instances_[i]->after_market_event(e, market.trades);
+            }
+        }
+        market.events += batch.size();
+
+        for (std::size_t i = worker; i < instances_.size(); i += workers) {
+            Instance& inst = *instances_[i];
+            inst.end_market_batch(batch);
+            if (!options_.keep_records) inst.clear_records();
+        }
+        market.engine.perf.clear();
+    }
+
+    SweepOptions options_;
+    std::size_t workers_{1};
+    std::vector<std::unique_ptr<Market>> markets_;   // shared_market: one per worker
+    std::vector<std::unique_ptr<Instance>> instances_;
+};
+
+template<typename S>
+    requires Strategy<S> || GatewayHook<S>
+template<typename Source>
+void ParameterSweep<S>::run(Source&& source)
+{
+    const std::size_t batch_size = options_.batch_events;
+    const std::size_t workers    = workers_;
+
+    std::vector<HistoricalEvent> buffers[2];
+    buffers[0].reserve(batch_size);
+    buffers[1].reserve(batch_size);
+
+    // Single worker: no threads, decode and replay in turn
+    if (workers == 1) {
+        source([&](const HistoricalEvent& e) {
+            buffers[0].push_back(e);
+            if (buffers[0].size() == batch_size) {
+                replay_slice(0, 1, buffers[0]);
+                buffers[0].clear();
+            }
+        });
+        if (!buffers[0].empty()) replay_slice(0, 1, buffers[0]);
+        return;
+    }
+
+    // Decoder (this thread) + workers meet once per batch. At each phase
+    // boundary the workers are done with buffers[cur ^ 1] and the decoder
+    // has filled buffers[cur]; an empty buffer ends the run.
+    //
+    // Failures never strand a thread at the barrier: a throwing worker
+    // records its exception, raises `stop` and keeps meeting the decoder
+    // without replaying; the decoder abandons the source on `stop` (or on
+    // its own exception) and still publishes the empty batch. The first
+    // exception is rethrown once every thread has joined.
+    struct Stopped {};
+    std::barrier sync(static_cast<std::ptrdiff_t>(workers + 1));
+    std::size_t cur = 0;
+    std::atomic<bool> stop{false};
+    std::vector<std::exception_ptr> errors(workers + 1);
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (std::size_t w = 0; w < workers; ++w) {
+        threads.emplace_back([&, w] {
+            std::size_t mine = 0;
+            for (;;) {
+                sync.arrive_and_wait();
+                const auto& batch = buffers[mine];
+                if (batch.empty()) break;
+                if (!stop.load(std::memory_order_relaxed)) {
+                    try {
+                        replay_slice(w, workers, batch);
+                    } catch (...) {
+                        errors[w + 1] = std::current_exception();
+                        stop.store(true, std::memory_order_relaxed);
+                    }
+                }
+                mine ^= 1;
+            }
+        });
+    }
+
+    auto publish = [&] {
+        sync.arrive_and_wait();   // workers pick up buffers[cur]
+        cur ^= 1;
+        buffers[cur].clear();     // their previous batch: free since the barrier
+    };
+
+    try {
+        source([&](const HistoricalEvent& e) {
+            if (stop.load(std::memory_order_relaxed)) throw Stopped{};
+            buffers[cur].push_back(e);
+            if (buffers[cur].size() == batch_size) publish();
+        });
+        if (!buffers[cur].empty()) publish();
+    } catch (const Stopped&) {
+        // a worker failed; its exception is rethrown below
+    } catch (...) {
+        errors[0] = std::current_exception();
+    }
+
+    // Empty batch: stop
+    buffers[cur].clear();
+    sync.arrive_and_wait();
+
+    for (auto& t : threads) t.join();
+
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+/* USAGE: 500 parameter sets over one decode of the day
+    std::vector<double> thresholds = ...;   // 500 values
+    lob::SweepOptions opts;
+    opts.shared_market = true;               // match the day once per core
+    lob::ParameterSweep<MyStrategy> sweep(thresholds.size(),
+        [&](std::size_t i) { return MyStrategy{thresholds[i]}; }, opts);
+
+    sweep.run([&](auto&& sink) { lob::for_each_itch_event(file, sink); });
+    auto pnl = sweep.collect([](const auto& inst) { return inst.strategy().pnl; });
+*/
+
+} // namespace lob
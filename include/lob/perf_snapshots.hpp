@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <map>
+#include <memory_resource>
 #include <chrono>
 #include <algorithm>
 #include <cstdint>
@@ -30,12 +31,42 @@ inline Timestamp current_timestamp() {
 struct PerfStats {
     std::mutex mtx;
 
-    std::vector<double> latencies_us;   // microseconds per match
+    std::pmr::vector<double> latencies_us;   // microseconds per match
     size_t pool_alloc_count = 0;
 
+    // `window` > 0 keeps only the most recent `window` samples, in a buffer
+    // sized up front; 0 keeps every sample
+    explicit PerfStats(std::pmr::memory_resource* mr = std::pmr::get_default_resource(),
+                       size_t window = 0)
+        : latencies_us(mr), window_(window)
+    {
+        latencies_us.reserve(window);
+    }
+
+    // Pre-size the sample buffer so recording never allocates; a bounded
+    // window grows to at least `samples`
+    void reserve(size_t samples) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (window_ != 0 && samples > window_) {
+            // A wrapped ring is oldest-first from next_; new samples are
+            // appended after growing, so put the oldest at the front
+            std::rotate(latencies_us.begin(),
+                        latencies_us.begin() + static_cast<std::ptrdiff_t>(next_),
+                        latencies_us.end());
+            next_ = 0;
+            window_ = samples;
+        }
+        latencies_us.reserve(samples);
+    }
+
     void record(double us) {
         std::lock_guard<std::mutex> lock(mtx);
-        latencies_us.push_back(us);
+        if (window_ == 0 || latencies_us.size() < window_) {
+            latencies_us.push_back(us);
+        } else {
+            latencies_us[next_] = us;   // overwrite the oldest
+            next_ = (next_ + 1) % window_;
+        }
     }
 
     void record_allocation() {
@@ -47,7 +78,7 @@ struct PerfStats {
         if (latencies_us.empty()) 
             return 0.0;
 
-        std::vector<double> tmp = latencies_us;
+        std::vector<double> tmp(latencies_us.begin(), latencies_us.end());
         std::sort(tmp.begin(), tmp.end());
 
         // safe conversion
@@ -67,7 +98,12 @@ struct PerfStats {
         std::lock_guard<std::mutex> lock(mtx);
         latencies_us.clear();
         pool_alloc_count = 0;
+        next_ = 0;
     }
+
+private:
+    size_t window_ = 0;
+    size_t next_ = 0;   // oldest sample once the window is full
 };
 
 // ------------------------
@@ -84,8 +120,8 @@ struct PriceLevelSnapshot {
 // ------------------------
 struct BookSnapshot {
     Timestamp ts;
-    std::vector<PriceLevelSnapshot> top_bids;
-    std::vector<PriceLevelSnapshot> top_asks;
+    std::pmr::vector<PriceLevelSnapshot> top_bids;
+    std::pmr::vector<PriceLevelSnapshot> top_asks;
 
     void print() const {
         std::cout << "Snapshot @ " << ts << " us\n";
@@ -104,16 +140,18 @@ struct BookSnapshot {
 // Capture snapshot from OrderBook
 // ------------------------
 template<typename OrderBook>
-inline BookSnapshot capture_snapshot(const OrderBook& book, size_t top_n = 5) {
-    BookSnapshot snap;
-    snap.ts = current_timestamp();
-
-    // Capture top bids (sorted descending)
+inline BookSnapshot capture_snapshot(const OrderBook& book, size_t top_n = 5,
+                                     std::pmr::memory_resource* mr = std::pmr::get_default_resource()) {
+    BookSnapshot snap{current_timestamp(), std::pmr::vector<PriceLevelSnapshot>(mr),
+                      std::pmr::vector<PriceLevelSnapshot>(mr)};
+    snap.top_bids.reserve(top_n);
+    snap.top_asks.reserve(top_n);
+
+    // Capture top bids (levels are stored best first, i.e. descending)
     size_t count = 0;
-    for (auto it = book.bids().rbegin(); it != book.bids().rend() && count < top_n; ++it, ++count) {
+    for (auto it = book.bids().begin(); it != book.bids().end() && count < top_n; ++it, ++count) {
         const auto& lvl = it->second;
-        size_t orders = 0;
-        for (Order* o = lvl.head; o; o = o->next) ++orders;
+        size_t orders = lvl.order_count;
         snap.top_bids.push_back({lvl.price, lvl.total_volume, orders});
     }
 
@@ -121,8 +159,7 @@ inline BookSnapshot capture_snapshot(const OrderBook& book, size_t top_n = 5) {
     count = 0;
     for (auto it = book.asks().begin(); it != book.asks().end() && count < top_n; ++it, ++count) {
         const auto& lvl = it->second;
-        size_t orders = 0;
-        for (Order* o = lvl.head; o; o = o->next) ++orders;
+        size_t orders = lvl.order_count;
         snap.top_asks.push_back({lvl.price, lvl.total_volume, orders});
     }
 
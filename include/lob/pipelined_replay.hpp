@@ -0,0 +1,276 @@
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <memory_resource>
+#include <span>
+#include <thread>
+#include <vector>
+#include "replay.hpp"
+#include "spsc_ring.hpp"
+
+namespace lob {
+
+// ------------------------
+// PipelinedReplay: three-stage replay connected by SPSC rings
+// ------------------------
+//
+//   [decode thread] --events--> [calling thread: matching] --records--> [analytics thread]
+//
+// Stage 1 runs the event source (a loader, a generator, or a vector walk).
+// Stage 2 applies each event to the MatchingEngine and forwards its trades
+// followed by one snapshot record. Stage 3 stores trades and snapshots and
+// runs the strategy hooks. Rings are FIFO, so output order is identical
+// to a single-threaded feed_events; full rings stall the upstream stage.
+//
+// A strategy with on_book_update or before_event needs the live book, so
+// it runs entirely on the matching stage; stage 3 then only persists.
+// on_event_batch fires every `batch_size` events and once at the end.
+//
+// If a stage throws, the others wind down (the source is abandoned, the
+// rings are drained) and run() rethrows once both threads have joined.
+//
+// `mr` backs the rings and the recorded trades and snapshots. The analytics
+// thread allocates from it while the matching thread allocates from the
+// book's resource, so the two must not be one unsynchronized pool.
+// Per-event scratch on the matching thread uses the book's resource.
+class PipelinedReplay {
+public:
+    explicit PipelinedReplay(MatchingEngine& engine, std::size_t ring_capacity = 1 << 14,
+                             std::size_t batch_size = 1024,
+                             std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : engine_(engine), events_(ring_capacity, mr), records_(ring_capacity, mr),
+          batch_size_(batch_size == 0 ? 1 : batch_size), trades_(mr), analytics_(mr) {}
+
+    void set_strategy_callback(StrategyCallback cb) {
+        callback_.callback = std::move(cb);
+    }
+
+    // `source` is invoked on the decode thread as `source(sink)` and must
+    // call `sink(const HistoricalEvent&)` for every event, in order.
+    template<typename Source, Strategy S>
+    void run(Source&& source, S& strategy);
+
+    template<typename Source>
+    void run(Source&& source)
+    {
+        run(std::forward<Source>(source), callback_);
+    }
+
+    void run(const std::vector<HistoricalEvent>& events)
+    {
+        run([&events](auto&& sink) {
+            for (const auto& e : events) sink(e);
+        });
+    }
+
+    const TradeBuffer& trades() const noexcept { return trades_; }
+    const AnalyticsBuffer& analytics() const noexcept { return analytics_; }
+
+private:
+    struct DecodedEvent {
+        HistoricalEvent event;
+        bool end;
+    };
+
+    // One payload per record. Events only travel when stage 3 runs the
+    // on_event_batch hook; a default record is the End marker.
+    struct ReplayRecord {
+        enum class Kind : uint8_t { Trade, Snapshot, Event, End };
+
+        Kind kind{Kind::End};
+        union {
+            TradeEvent trade;
+            AnalyticsSnapshot snapshot;
+            HistoricalEvent event;
+        };
+
+        ReplayRecord() noexcept : trade{} {}
+        explicit ReplayRecord(const TradeEvent& t) noexcept : kind(Kind::Trade), trade(t) {}
+        explicit ReplayRecord(const AnalyticsSnapshot& s) noexcept : kind(Kind::Snapshot), snapshot(s) {}
+        explicit ReplayRecord(const HistoricalEvent& e) noexcept : kind(Kind::Event), event(e) {}
+    };
+
+    template<Strategy S>
+    void match_stage(S& strategy);
+
+    template<Strategy S>
+    void analytics_stage(S& strategy);
+
+    template<Strategy S, typename Batch>
+    void flush_batch(S& strategy, Batch& batch)
+    {
+        if constexpr (EventBatchHook<S>) {
+            if (!batch.empty()) strategy.on_event_batch(std::span<const HistoricalEvent>(batch));
+        }
+        batch.clear();
+    }
+
+    MatchingEngine& engine_;
+    CallbackStrategy callback_;
+
+    SpscRing<DecodedEvent> events_;
+    SpscRing<ReplayRecord> records_;
+    std::size_t batch_size_;
+
+    TradeBuffer trades_;
+    AnalyticsBuffer analytics_;
+
+    // Failure handling in run(): `stop_` is raised by a failing stage;
+    // each flag is owned by the stage that consumes the marker
+    std::atomic<bool> stop_{false};
+    bool events_done_{false};    // matching stage popped the end marker
+    bool records_done_{false};   // analytics stage popped the End record
+};
+
+template<typename Source, Strategy S>
+void PipelinedReplay::run(Source&& source, S& strategy)
+{
+    // A failing stage records its exception, raises stop_ and keeps
+    // draining its input so no neighbour blocks on a ring: the decoder
+    // abandons the source but still sends the end marker, the matching
+    // stage always sends End, and stage 3 reads on to End. The first
+    // exception (in stage order) is rethrown once both threads have joined.
+    struct Stopped {};
+    std::exception_ptr errors[3];   // decode, match, analytics
+    stop_.store(false, std::memory_order_relaxed);
+    events_done_ = false;
+    records_done_ = false;
+
+    std::thread decoder([this, &source, &errors] {
+        try {
+            source([this](const HistoricalEvent& e) {
+                if (stop_.load(std::memory_order_relaxed)) throw Stopped{};
+                events_.push(DecodedEvent{e, false});
+            });
+        } catch (const Stopped&) {
+            // a later stage failed; its exception is rethrown below
+        } catch (...) {
+            errors[0] = std::current_exception();
+        }
+        events_.push(DecodedEvent{HistoricalEvent{}, true});
+    });
+
+    std::thread analytics([this, &strategy, &errors] {
+        try {
+            analytics_stage(strategy);
+        } catch (...) {
+            errors[2] = std::current_exception();
+            stop_.store(true, std::memory_order_relaxed);
+        }
+        for (ReplayRecord rec; !records_done_;) {
+            records_.pop(rec);
+            records_done_ = rec.kind == ReplayRecord::Kind::End;
+        }
+    });
+
+    try {
+        match_stage(strategy);
+    } catch (...) {
+        errors[1] = std::current_exception();
+        stop_.store(true, std::memory_order_relaxed);
+        records_.push(ReplayRecord{});   // match_stage sends End last, so not yet
+    }
+    for (DecodedEvent in{}; !events_done_;) {
+        events_.pop(in);
+        events_done_ = in.end;
+    }
+
+    decoder.join();
+    analytics.join();
+
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+template<Strategy S>
+void PipelinedReplay::match_stage(S& strategy)
+{
+    constexpr bool hooks_here = MatchingStageStrategy<S>;
+
+    std::pmr::memory_resource* mr = engine_.book().resource();
+    TradeBuffer scratch(mr);
+    std::pmr::vector<HistoricalEvent> batch(mr);
+    DecodedEvent in{};
+
+    for (;;) {
+        // Kills are applied between events, and while the feed is idle:
+        // one poll per pop attempt, so once per event on a busy feed
+        for (unsigned spins = 0;; ++spins) {
+            engine_.poll_risk();
+            if (events_.try_pop(in)) break;
+            if (spins >= 64) std::this_thread::yield();
+        }
+        if (in.end) {
+            events_done_ = true;
+            break;
+        }
+        if (stop_.load(std::memory_order_relaxed)) break;   // stage 3 failed
+
+        scratch.clear();
+        if constexpr (PreEventHook<S>) strategy.before_event(in.event, scratch);
+        apply_event(engine_, in.event, scratch);
+
+        for (const auto& t : scratch) {
+            if constexpr (hooks_here && TradeHook<S>) strategy.on_trade(t);
+            records_.push(ReplayRecord{t});
+        }
+        records_.push(ReplayRecord{make_analytics_snapshot(engine_.book(), in.event.ts)});
+        if constexpr (!hooks_here && EventBatchHook<S>) records_.push(ReplayRecord{in.event});
+
+        if constexpr (hooks_here) {
+            if constexpr (BookUpdateHook<S>) strategy.on_book_update(engine_.book(), in.event);
+            batch.push_back(in.event);
+            if (batch.size() >= batch_size_) flush_batch(strategy, batch);
+        }
+    }
+
+    if constexpr (hooks_here) {
+        if (!stop_.load(std::memory_order_relaxed)) flush_batch(strategy, batch);
+    }
+
+    records_.push(ReplayRecord{});
+}
+
+template<Strategy S>
+void PipelinedReplay::analytics_stage(S& strategy)
+{
+    constexpr bool hooks_here = !MatchingStageStrategy<S>;
+
+    std::pmr::vector<HistoricalEvent> batch(trades_.get_allocator().resource());
+    ReplayRecord rec;
+
+    for (;;) {
+        records_.pop(rec);
+        switch (rec.kind) {
+            case ReplayRecord::Kind::Trade:
+                trades_.push_back(rec.trade);
+                if constexpr (hooks_here && TradeHook<S>) strategy.on_trade(rec.trade);
+                break;
+            case ReplayRecord::Kind::Snapshot:
+                analytics_.push_back(rec.snapshot);
+                break;
+            case ReplayRecord::Kind::Event:
+                if constexpr (hooks_here && EventBatchHook<S>) {
+                    batch.push_back(rec.event);
+                    if (batch.size() >= batch_size_) flush_batch(strategy, batch);
+                }
+                break;
+            case ReplayRecord::Kind::End:
+                records_done_ = true;
+                if constexpr (hooks_here) {
+                    if (!stop_.load(std::memory_order_relaxed)) flush_batch(strategy, batch);
+                }
+                return;
+        }
+    }
+}
+
+/* USAGE: Decode a file on its own core while matching runs on this one
+    lob::MatchingEngine engine(1 << 20);
+    lob::PipelinedReplay replay(engine);
+    replay.run([&](auto&& sink) { lob::load_itch_file(path, sink, locate); });
+*/
+
+} // namespace lob
@@ -2,11 +2,15 @@
 
 #include "types.hpp"
 #include "order.hpp"
+#include <cstddef>
 
 struct PriceLevel {
     Price price{};
     Quantity total_volume{0};
-    
+    std::size_t order_count{0};
+
     Order* head{nullptr};
     Order* tail{nullptr};
+
+    Order* tracked_head{nullptr};   // orders whose queue position is maintained
 };
\ No newline at end of file
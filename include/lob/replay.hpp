@@ -0,0 +1,122 @@
+#pragma once
+#include "matching_engine.hpp"
+#include <concepts>
+#include <functional>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace lob {
+
+enum class EventType {
+    LIMIT,   // New limit order
+    CANCEL,  // Cancel existing order
+    MODIFY   // Modify existing order (price/quantity)
+};
+
+struct HistoricalEvent {
+    EventId id;             // unique identifier for event
+    EventType type;         // LIMIT, CANCEL, MODIFY
+    OrderId order_id;
+    Side side;
+    Price price;
+    Quantity qty;
+    Timestamp ts;
+    ParticipantId participant{0};   // owner of LIMIT orders; 0 = anonymous
+};
+
+struct AnalyticsSnapshot {
+    Timestamp ts;
+    Price mid_price;
+    Quantity total_volume;
+    // Additional metrics: bid/ask spread, depth, etc.
+};
+
+using AnalyticsBuffer = std::pmr::vector<AnalyticsSnapshot>;
+
+// Apply one historical event to the engine, appending any resulting trades.
+// Shared by every replay path so they stay behaviourally identical.
+template<TradeSink B>
+void apply_event(MatchingEngine& engine, const HistoricalEvent& e, B& trades);
+
+// Simplest analytics: mid-price & total volume
+AnalyticsSnapshot make_analytics_snapshot(const OrderBook& book, Timestamp ts);
+
+// ------------------------
+// Strategy hooks
+// ------------------------
+// A strategy is any type providing at least one of:
+//
+//     void on_trade(const TradeEvent&);                          // per trade
+//     void on_book_update(const OrderBook&, const HistoricalEvent&); // per event, after matching
+//     void on_event_batch(std::span<const HistoricalEvent>);      // once per batch of applied events
+//     void before_event(const HistoricalEvent&, TradeBuffer&); // per event, before matching
+//
+// before_event lets a strategy drive the engine itself (e.g. its own
+// orders arriving ahead of the event); trades it appends are reported
+// through on_trade like any other.
+//
+// Hooks are resolved at compile time, so missing ones cost nothing and
+// present ones can be inlined into the replay loop.
+template<typename S>
+concept TradeHook = requires(S& s, const TradeEvent& t) { s.on_trade(t); };
+
+template<typename S>
+concept BookUpdateHook = requires(S& s, const OrderBook& b, const HistoricalEvent& e) { s.on_book_update(b, e); };
+
+template<typename S>
+concept EventBatchHook = requires(S& s, std::span<const HistoricalEvent> batch) { s.on_event_batch(batch); };
+
+template<typename S>
+concept PreEventHook = requires(S& s, const HistoricalEvent& e, TradeBuffer& trades) {
+    s.before_event(e, trades);
+};
+
+template<typename S>
+concept Strategy = TradeHook<S> || BookUpdateHook<S> || EventBatchHook<S> || PreEventHook<S>;
+
+// Strategies that touch the live book must run on the matching thread
+template<typename S>
+concept MatchingStageStrategy = BookUpdateHook<S> || PreEventHook<S>;
+
+using StrategyCallback = std::function<void(const TradeEvent&)>;
+
+// Adapter that runs a type-erased callback through the template hooks
+struct CallbackStrategy {
+    StrategyCallback callback;
+
+    void on_trade(const TradeEvent& t) {
+        if (callback) callback(t);
+    }
+};
+
+// One event through matching, persistence and the per-event hooks.
+// on_event_batch is left to the caller, which knows the batch bounds.
+// Output goes to std::vector or pmr buffers alike; before_event hooks are
+// written against TradeBuffer.
+template<Strategy S, TradeSink B, typename Analytics>
+inline void replay_one(MatchingEngine& engine, const HistoricalEvent& e,
+                       B& trades,
+                       Analytics& analytics,
+                       S& strategy)
+{
+    engine.poll_risk();   // pending kills land between events, whatever the event
+
+    const std::size_t first = trades.size();
+    if constexpr (PreEventHook<S>) {
+        strategy.before_event(e, trades);
+    }
+    apply_event(engine, e, trades);
+
+    if constexpr (TradeHook<S>) {
+        for (std::size_t i = first; i < trades.size(); ++i) strategy.on_trade(trades[i]);
+    }
+
+    analytics.push_back(make_analytics_snapshot(engine.book(), e.ts));
+
+    if constexpr (BookUpdateHook<S>) {
+        strategy.on_book_update(engine.book(), e);
+    }
+}
+
+} // namespace lob
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include "order_book.hpp"
+
+namespace lob {
+
+// Per-account limits; 0 disables a check
+struct RiskLimits {
+    Quantity max_order_qty{0};
+    Price price_collar{0};            // ticks an order may reach through the opposite touch
+    Quantity max_open_notional{0};    // resting price * qty, including the new order
+    uint32_t max_messages{0};         // orders + modifies per rate window
+    Timestamp rate_window_ns{1'000'000'000};
+};
+
+enum class RiskResult : uint8_t {
+    Accepted,
+    KillSwitch,       // account is killed
+    UnknownAccount,   // owner has no limits configured
+    MessageRate,
+    OrderSize,
+    PriceCollar,
+    OpenNotional,
+    NoReferencePrice   // collared account, but no opposite touch and no trade yet
+};
+
+// Orders from owners that have no slot (set_limits never called)
+enum class UnknownAccountPolicy : uint8_t {
+    Reject,   // refuse them as UnknownAccount (default)
+    Accept    // let them through unchecked, like anonymous flow
+};
+
+// ------------------------
+// RiskEngine: pre-trade checks on the engine's command path
+// ------------------------
+// Owned by a MatchingEngine (enable_risk_checks). Every non-anonymous
+// order and every modify that adds risk is checked before it reaches the
+// matcher; rejected orders are returned to the pool. Anonymous flow
+// (owner 0, e.g. replayed market data) is never checked.
+//
+// Each account has one preallocated, cache-line aligned slot indexed by
+// ParticipantId. Open notional is not tracked here: the slot caches a
+// pointer to the book's ParticipantState, which already moves with every
+// rest, fill and cancel. A check is a handful of loads and compares.
+//
+// Owners without limits are rejected as UnknownAccount unless the policy
+// is set to Accept (set_unknown_account_policy).
+//
+// Everything runs on the engine thread except kill(), which any thread may
+// call: it flags the account, its orders are rejected at once, and the
+// engine flattens it (cancel_participant) at its next command or
+// MatchingEngine::poll_risk(), whichever comes first.
+class RiskEngine {
+public:
+    // Accounts are ParticipantIds in [1, max_accounts)
+    RiskEngine(OrderBook& book, std::size_t max_accounts,
+               std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+
+    RiskEngine(const RiskEngine&) = delete;
+    RiskEngine& operator=(const RiskEngine&) = delete;
+
+    // Register (or update) an account; false if `account` has no slot
+    bool set_limits(ParticipantId account, const RiskLimits& limits);
+
+    // nullptr if the account is not registered
+    const RiskLimits* limits(ParticipantId account) const noexcept;
+
+    std::size_t capacity() const noexcept { return slots_.size(); }
+
+    void set_unknown_account_policy(UnknownAccountPolicy policy) noexcept { unknown_ = policy; }
+    UnknownAccountPolicy unknown_account_policy() const noexcept { return unknown_; }
+
+    // Collar reference when the opposite side is empty; the engine reports
+    // the last fill of each order and each uncross here
+    void on_trade(Price price) noexcept
+    {
+        last_trade_ = price;
+        traded_ = true;
+    }
+
+    // ---- Checks (engine thread) ----
+
+    RiskResult check_order(const Order& order) noexcept
+    {
+        Slot* slot = lookup(order.owner);
+        if (!slot) return unknown();
+
+        const RiskResult r = admit(*slot, order.ts);
+        if (r != RiskResult::Accepted) return tally(*slot, r);
+
+        return tally(*slot, check_exposure(*slot, order.side, order.price, order.qty,
+                                            order.price * order.qty));
+    }
+
+    // Modify of a resting order to (new_price, new_qty). Cancels and
+    // same-price size-downs only reduce risk and always pass.
+    RiskResult check_modify(const Order& order, Price new_price, Quantity new_qty,
+                            Timestamp ts) noexcept
+    {
+        if (new_qty <= 0 || (new_price == order.price && new_qty <= order.remaining)) {
+            return RiskResult::Accepted;
+        }
+
+        Slot* slot = lookup(order.owner);
+        if (!slot) return unknown();
+
+        const RiskResult r = admit(*slot, ts);
+        if (r != RiskResult::Accepted) return tally(*slot, r);
+
+        const Quantity added = new_price * new_qty - order.price * order.remaining;
+        return tally(*slot, check_exposure(*slot, order.side, new_price, new_qty, added));
+    }
+
+    // ---- Kill switch ----
+
+    // Thread-safe: block the account and request a flatten
+    void kill(ParticipantId account) noexcept;
+
+    // Accept orders from the account again (its cancelled orders stay cancelled)
+    void revive(ParticipantId account) noexcept;
+
+    bool killed(ParticipantId account) const noexcept;
+
+    // Engine thread: flatten every killed account with open orders; cheap
+    // (one relaxed load) unless a kill is pending. Returns orders cancelled.
+    std::size_t apply_kills()
+    {
+        if (kills_pending_.load(std::memory_order_relaxed) == 0) return 0;
+        return flatten_killed();
+    }
+
+    // Orders and modifies rejected for this account so far
+    uint64_t rejected(ParticipantId account) const noexcept;
+
+private:
+    struct alignas(64) Slot {
+        RiskLimits limits;
+        const ParticipantState* exposure{nullptr};   // the book's incremental state
+
+        Timestamp window_start{0};
+        uint32_t messages{0};
+        bool active{false};
+        std::atomic<bool> killed{false};   // written by kill() from any thread
+
+        uint64_t rejected{0};
+    };
+
+    Slot* lookup(ParticipantId account) noexcept
+    {
+        if (account >= slots_.size() || !slots_[account].active) return nullptr;
+        return &slots_[account];
+    }
+
+    RiskResult unknown() const noexcept
+    {
+        return unknown_ == UnknownAccountPolicy::Accept ? RiskResult::Accepted
+                                                        : RiskResult::UnknownAccount;
+    }
+
+    static RiskResult tally(Slot& slot, RiskResult r) noexcept
+    {
+        if (r != RiskResult::Accepted) ++slot.rejected;
+        return r;
+    }
+
+    // Kill switch and message rate; every checked message counts, accepted or not
+    static RiskResult admit(Slot& slot, Timestamp ts) noexcept
+    {
+        if (slot.killed.load(std::memory_order_relaxed)) return RiskResult::KillSwitch;
+
+        if (slot.limits.max_messages) {
+            if (ts - slot.window_start >= slot.limits.rate_window_ns) {
+                slot.window_start = ts;
+                slot.messages = 0;
+            }
+            if (++slot.messages > slot.limits.max_messages) return RiskResult::MessageRate;
+        }
+        return RiskResult::Accepted;
+    }
+
+    RiskResult check_exposure(const Slot& slot, Side side, Price price, Quantity qty,
+                              Quantity added_notional) const noexcept
+    {
+        const RiskLimits& l = slot.limits;
+
+        if (l.max_order_qty && qty > l.max_order_qty) return RiskResult::OrderSize;
+
+        // Collar: a buy may not reach more than `price_collar` ticks above the
+        // best ask, a sell not below the best bid. With the opposite side
+        // empty the last trade is the reference; with neither, reject.
+        if (l.price_collar) {
+            const PriceLevel* touch = (side == Side::Buy) ? AskSide::best(book_.asks())
+                                                          : BidSide::best(book_.bids());
+            if (!touch && !traded_) return RiskResult::NoReferencePrice;
+
+            const Price ref = touch ? touch->price : last_trade_;
+            const Price through = (side == Side::Buy) ? price - ref : ref - price;
+            if (through > l.price_collar) return RiskResult::PriceCollar;
+        }
+
+        if (l.max_open_notional
+            && slot.exposure->open_notional + added_notional > l.max_open_notional) {
+            return RiskResult::OpenNotional;
+        }
+        return RiskResult::Accepted;
+    }
+
+    std::size_t flatten_killed();
+
+    OrderBook& book_;
+    std::pmr::vector<Slot> slots_;
+    std::atomic<uint32_t> kills_pending_{0};
+
+    UnknownAccountPolicy unknown_{UnknownAccountPolicy::Reject};
+    Price last_trade_{0};
+    bool traded_{false};
+};
+
+/* USAGE: Limits on one account, kill from a monitoring thread
+    lob::MatchingEngine engine(1 << 20);
+    lob::RiskEngine& risk = engine.enable_risk_checks(1024);
+
+    lob::RiskLimits limits;
+    limits.max_order_qty = 10'000;
+    limits.price_collar = 50;
+    limits.max_open_notional = 5'000'000;
+    limits.max_messages = 1000;   // per second
+    risk.set_limits(7, limits);
+
+    if (engine.submit_limit_order(order, trades) != lob::RiskResult::Accepted) { ... }
+
+    // any thread
+    risk.kill(7);   // orders rejected at once
+
+    // engine thread, e.g. between events or while the feed is idle
+    engine.poll_risk();   // account 7 flattened
+*/
+
+} // namespace lob
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
+namespace lob {
+
+// ------------------------
+// SpscRing: bounded lock-free single-producer / single-consumer queue
+// ------------------------
+// Capacity is rounded up to a power of two. Each side keeps a cached copy
+// of the other side's index so the shared cache line is only touched when
+// the ring looks full (producer) or empty (consumer).
+template<typename T>
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity,
+                      std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : buffer_(mr)
+    {
+        std::size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        buffer_.resize(cap);
+        mask_ = cap - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    std::size_t capacity() const noexcept { return mask_ + 1; }
+
+    bool try_push(const T& value) noexcept
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_cache_ > mask_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head - tail_cache_ > mask_) return false;   // full
+        }
+        buffer_[head & mask_] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& out) noexcept
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_cache_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail == head_cache_) return false;   // empty
+        }
+        out = buffer_[tail & mask_];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Blocking variants: spin briefly, then yield. A full ring stalls the
+    // producer, which is the backpressure between pipeline stages.
+    void push(const T& value) noexcept
+    {
+        for (unsigned spins = 0; !try_push(value); ++spins) {
+            if (spins >= kSpinLimit) std::this_thread::yield();
+        }
+    }
+
+    void pop(T& out) noexcept
+    {
+        for (unsigned spins = 0; !try_pop(out); ++spins) {
+            if (spins >= kSpinLimit) std::this_thread::yield();
+        }
+    }
+
+private:
+    static constexpr unsigned kSpinLimit = 64;
+
+    std::pmr::vector<T> buffer_;
+    std::size_t mask_{0};
+
+    // Producer-owned
+    alignas(64) std::atomic<std::size_t> head_{0};
+    std::size_t tail_cache_{0};
+
+    // Consumer-owned
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    std::size_t head_cache_{0};
+};
+
+} // namespace lob
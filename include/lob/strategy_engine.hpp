@@ -0,0 +1,241 @@
+#pragma once
+#include "matching_engine.hpp"
+#include "order_gateway.hpp"
+#include "pipelined_replay.hpp"
+#include "replay.hpp"
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace lob {
+
+// Strategies that place their own orders receive the gateway once
+template<typename S>
+concept GatewayHook = requires(S& s, OrderGateway& gw) { s.on_attach(gw); };
+
+namespace detail {
+
+// Forwards S's hooks and merges in-flight gateway orders ahead of each event
+template<typename S>
+struct GatewayBinding {
+    S& strategy;
+    OrderGateway& gateway;
+
+    void before_event(const HistoricalEvent& e, TradeBuffer& trades) {
+        gateway.advance_to(e.ts, trades);
+        if constexpr (PreEventHook<S>) strategy.before_event(e, trades);
+    }
+
+    void on_trade(const TradeEvent& t) requires TradeHook<S> {
+        strategy.on_trade(t);
+    }
+
+    void on_book_update(const OrderBook& book, const HistoricalEvent& e) requires BookUpdateHook<S> {
+        strategy.on_book_update(book, e);
+    }
+
+    void on_event_batch(std::span<const HistoricalEvent> batch) requires EventBatchHook<S> {
+        strategy.on_event_batch(batch);
+    }
+};
+
+} // namespace detail
+
+// ------------------------
+// StrategyEngine: PaperTradingEngine with a statically bound strategy
+// ------------------------
+// Same replay semantics as PaperTradingEngine, but the strategy is a
+// template parameter owned by the engine, so its hooks are direct calls
+// the compiler can inline. Every replay path fires the same hooks:
+// on_trade per trade, on_book_update per event, and on_event_batch once
+// per feed_event / feed_events call (per batch when pipelined).
+//
+// A strategy with on_attach(OrderGateway&) can also submit and cancel its
+// own orders; see OrderGateway for the latency and merge rules.
+//
+// Recorded trades, snapshots and in-flight gateway orders allocate from
+// the engine's resource; the std::allocator_arg form picks it for an
+// internally constructed engine.
+template<typename S>
+    requires Strategy<S> || GatewayHook<S>
+class StrategyEngine {
+public:
+    // --- Option 1: Construct internally ---
+    template<typename... Args>
+    explicit StrategyEngine(std::size_t pool_size, Args&&... args)
+        : StrategyEngine(std::allocator_arg, std::pmr::get_default_resource(), pool_size,
+                         std::forward<Args>(args)...) {}
+
+    template<typename... Args>
+    StrategyEngine(std::allocator_arg_t, std::pmr::memory_resource* mr, std::size_t pool_size,
+                   Args&&... args)
+        : owned_engine_(std::make_unique<MatchingEngine>(pool_size, mr)),
+          engine_(*owned_engine_),
+          gateway_(engine_),
+          strategy_(std::forward<Args>(args)...),
+          trades_(mr),
+          analytics_(mr)
+    {
+        attach();
+    }
+
+    // --- Option 2: Use an external engine ---
+    template<typename... Args>
+    explicit StrategyEngine(MatchingEngine& external_engine, Args&&... args)
+        : engine_(external_engine),
+          gateway_(engine_),
+          strategy_(std::forward<Args>(args)...),
+          trades_(engine_.book().resource()),
+          analytics_(engine_.book().resource())
+    {
+        attach();
+    }
+
+    void feed_event(const HistoricalEvent& e)
+    {
+        with_hooks([&](auto& hooks) {
+            replay_one(engine_, e, trades_, analytics_, hooks);
+        });
+        if constexpr (EventBatchHook<S>) {
+            strategy_.on_event_batch(std::span<const HistoricalEvent>(&e, 1));
+        }
+    }
+
+    void feed_events(std::span<const HistoricalEvent> events)
+    {
+        with_hooks([&](auto& hooks) {
+            for (const auto& e : events) {
+                replay_one(engine_, e, trades_, analytics_, hooks);
+            }
+        });
+        if constexpr (EventBatchHook<S>) {
+            if (!events.empty()) strategy_.on_event_batch(events);
+        }
+    }
+
+    void feed_events_pipelined(std::span<const HistoricalEvent> events,
+                               std::size_t ring_capacity = 1 << 14,
+                               std::size_t batch_size = 1024)
+    {
+        PipelinedReplay replay(engine_, ring_capacity, batch_size);
+        with_hooks([&](auto& hooks) {
+            replay.run([events](auto&& sink) {
+                for (const auto& e : events) sink(e);
+            }, hooks);
+        });
+
+        trades_.insert(trades_.end(), replay.trades().begin(), replay.trades().end());
+        analytics_.insert(analytics_.end(), replay.analytics().begin(), replay.analytics().end());
+    }
+
+    // ---- Shared market (ParameterSweep) ----
+    // The engine is a market replayed once for many followers, which must
+    // not modify it: the gateway runs in Shadow mode, and strategies with
+    // before_event are not supported. Per event, call before_market_event
+    // on every follower, apply the event to the engine once, then call
+    // after_market_event with its trades. Only the strategy's own fills
+    // are recorded; on_trade sees them and the market's trades.
+    void follow_market() noexcept { gateway_.set_mode(GatewayMode::Shadow); }
+
+    void before_market_event(const HistoricalEvent& e) requires (!PreEventHook<S>)
+    {
+        const std::size_t first = trades_.size();
+        gateway_.advance_to(e.ts, trades_);
+        report_trades(first);
+    }
+
+    void after_market_event(const HistoricalEvent& e, std::span<const TradeEvent> market)
+        requires (!PreEventHook<S>)
+    {
+        const std::size_t first = trades_.size();
+        gateway_.on_market_event(e, market, trades_);
+        if constexpr (TradeHook<S>) {
+            for (const auto& t : market) strategy_.on_trade(t);
+        }
+        report_trades(first);
+        if constexpr (BookUpdateHook<S>) strategy_.on_book_update(engine_.book(), e);
+    }
+
+    void end_market_batch(std::span<const HistoricalEvent> batch)
+    {
+        if constexpr (EventBatchHook<S>) {
+            if (!batch.empty()) strategy_.on_event_batch(batch);
+        }
+    }
+
+    // Deliver strategy orders still in flight after the last event
+    void flush_orders()
+    {
+        const std::size_t first = trades_.size();
+        gateway_.flush(trades_);
+        report_trades(first);
+    }
+
+    OrderGateway& gateway() noexcept { return gateway_; }
+
+    S& strategy() noexcept { return strategy_; }
+    const S& strategy() const noexcept { return strategy_; }
+
+    MatchingEngine& engine() noexcept { return engine_; }
+
+    const TradeBuffer& trades() const noexcept { return trades_; }
+    const AnalyticsBuffer& analytics() const noexcept { return analytics_; }
+
+    // Drop recorded trades and snapshots (capacity is kept), e.g. between
+    // batches of a long run whose results live in the strategy
+    void clear_records() noexcept
+    {
+        trades_.clear();
+        analytics_.clear();
+    }
+
+private:
+    void attach()
+    {
+        if constexpr (GatewayHook<S>) strategy_.on_attach(gateway_);
+    }
+
+    void report_trades(std::size_t first)
+    {
+        if constexpr (TradeHook<S>) {
+            for (std::size_t i = first; i < trades_.size(); ++i) strategy_.on_trade(trades_[i]);
+        }
+    }
+
+    // Order-placing strategies go through the binding; others are called directly
+    template<typename F>
+    void with_hooks(F&& f)
+    {
+        if constexpr (GatewayHook<S>) {
+            detail::GatewayBinding<S> bound{strategy_, gateway_};
+            f(bound);
+        } else {
+            f(strategy_);
+        }
+    }
+
+    std::unique_ptr<MatchingEngine> owned_engine_; // only used if constructed internally
+    MatchingEngine& engine_;
+
+    OrderGateway gateway_;
+    S strategy_;
+
+    TradeBuffer trades_;
+    AnalyticsBuffer analytics_;
+};
+
+/* USAGE: Hooks are optional; implement only what the strategy needs
+    struct Momentum {
+        Quantity traded = 0;
+        void on_trade(const lob::TradeEvent& t) { traded += t.quantity; }
+        void on_book_update(const lob::OrderBook& book, const lob::HistoricalEvent& e) { ... }
+    };
+
+    lob::StrategyEngine<Momentum> engine(1 << 20);
+    engine.feed_events(events);
+    auto traded = engine.strategy().traded;
+*/
+
+} // namespace lob
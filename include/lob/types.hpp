@@ -6,4 +6,5 @@ using OrderId   = uint64_t;
 using EventId   = uint64_t;
 using Price     = int64_t;   // price in ticks
 using Quantity  = int64_t;
-using Timestamp = uint64_t;  // nanoseconds
\ No newline at end of file
+using Timestamp = uint64_t;  // nanoseconds
+using ParticipantId = uint32_t; // 0 = anonymous
\ No newline at end of file
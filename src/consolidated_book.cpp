@@ -0,0 +1,136 @@
+#include "lob/consolidated_book.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace lob {
+
+ConsolidatedBook::ConsolidatedBook(std::span<OrderBook* const> venues)
+    : venues_(venues.begin(), venues.end()),
+      leaves_(std::bit_ceil(std::max<std::size_t>(venues.size(), 1)))
+{
+    for (int s = 0; s < 2; ++s) {
+        tops_[s].assign(venues_.size(), Top{});
+        tree_[s].assign(2 * leaves_, kNoVenue);
+        for (VenueId v = 0; v < venues_.size(); ++v) {
+            tree_[s][leaves_ + v] = v;
+        }
+    }
+
+    bid_cursors_.reserve(venues_.size());
+    ask_cursors_.reserve(venues_.size());
+    chained_.reserve(venues_.size());
+
+    for (VenueId v = 0; v < venues_.size(); ++v) {
+        refresh(v, Side::Buy);
+        refresh(v, Side::Sell);
+        chained_.push_back(venues_[v]->top_of_book_listener());
+        venues_[v]->set_top_of_book_listener([this, v](Side side) {
+            if (chained_[v]) chained_[v](side);
+            refresh(v, side);
+        });
+    }
+}
+
+ConsolidatedBook::~ConsolidatedBook()
+{
+    for (VenueId v = 0; v < venues_.size(); ++v) {
+        venues_[v]->set_top_of_book_listener(std::move(chained_[v]));
+    }
+}
+
+std::optional<VenueLevel> ConsolidatedBook::best(Side side) const noexcept
+{
+    const int s = static_cast<int>(side);
+    const uint32_t v = tree_[s][1];
+    if (v == kNoVenue || !tops_[s][v].present) return std::nullopt;
+    return VenueLevel{tops_[s][v].price, tops_[s][v].volume, v};
+}
+
+void ConsolidatedBook::refresh(VenueId venue, Side side)
+{
+    if (side == Side::Buy) {
+        refresh_side<Side::Buy>(venue);
+    } else {
+        refresh_side<Side::Sell>(venue);
+    }
+}
+
+template<Side S>
+void ConsolidatedBook::refresh_side(VenueId venue)
+{
+    constexpr int s = static_cast<int>(S);
+
+    const PriceLevel* level = BookSide<S>::best(venues_[venue]->levels<S>());
+    tops_[s][venue] = level ? Top{level->price, level->total_volume, true} : Top{};
+
+    // Replay the matches on the path to the root
+    auto& tree = tree_[s];
+    for (std::size_t k = (leaves_ + venue) / 2; k >= 1; k /= 2) {
+        tree[k] = winner<S>(tree[2 * k], tree[2 * k + 1]);
+    }
+}
+
+template<Side S>
+uint32_t ConsolidatedBook::winner(uint32_t a, uint32_t b) const noexcept
+{
+    constexpr int s = static_cast<int>(S);
+    const bool has_a = a != kNoVenue && tops_[s][a].present;
+    const bool has_b = b != kNoVenue && tops_[s][b].present;
+    if (!has_b) return a;
+    if (!has_a) return b;
+
+    // Better price wins; ties go to the lower venue id (the left child)
+    return BookSide<S>::better(tops_[s][b].price, tops_[s][a].price) ? b : a;
+}
+
+std::size_t ConsolidatedBook::depth(Side side, std::span<VenueLevel> out) const
+{
+    return side == Side::Buy ? merge<Side::Buy>(out) : merge<Side::Sell>(out);
+}
+
+template<Side S>
+std::size_t ConsolidatedBook::merge(std::span<VenueLevel> out) const
+{
+    constexpr int s = static_cast<int>(S);
+    using Levels = typename BookSide<S>::Levels;
+
+    // Heap top = best price, then lowest venue
+    auto worse = [](const Cursor<S>& a, const Cursor<S>& b) {
+        if (a.it->first != b.it->first) return BookSide<S>::better(b.it->first, a.it->first);
+        return a.venue > b.venue;
+    };
+
+    auto& heap = cursors<S>();   // reserved for every venue: no allocation
+    heap.clear();
+    for (VenueId v = 0; v < venues_.size(); ++v) {
+        if (!tops_[s][v].present) continue;   // cached: empty venues cost nothing
+        const Levels& levels = venues_[v]->template levels<S>();
+        heap.push_back({levels.begin(), levels.end(), v});
+    }
+
+    // Every venue shows its top before anything behind it, so only the
+    // out.size() best tops can reach the output
+    if (heap.size() > out.size()) {
+        const auto keep = heap.begin() + static_cast<std::ptrdiff_t>(out.size());
+        std::nth_element(heap.begin(), keep, heap.end(),
+                         [&](const Cursor<S>& a, const Cursor<S>& b) { return worse(b, a); });
+        heap.erase(keep, heap.end());
+    }
+    std::make_heap(heap.begin(), heap.end(), worse);
+
+    std::size_t n = 0;
+    while (n < out.size() && !heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), worse);
+        Cursor<S>& c = heap.back();
+        out[n++] = VenueLevel{c.it->first, c.it->second.total_volume, c.venue};
+
+        if (++c.it == c.end) {
+            heap.pop_back();
+        } else {
+            std::push_heap(heap.begin(), heap.end(), worse);
+        }
+    }
+    return n;
+}
+
+} // namespace lob
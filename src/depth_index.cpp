@@ -0,0 +1,104 @@
+#include "lob/depth_index.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace lob {
+
+DepthIndex::DepthIndex(Price lo, Price hi, std::pmr::memory_resource* mr)
+    : lo_(lo), hi_(hi),
+      volume_{std::pmr::vector<Quantity>(mr), std::pmr::vector<Quantity>(mr)},
+      notional_{std::pmr::vector<Quantity>(mr), std::pmr::vector<Quantity>(mr)}
+{
+    if (hi < lo) {
+        throw std::invalid_argument("DepthIndex: empty price window");
+    }
+    size_ = static_cast<std::size_t>(hi - lo) + 1;
+
+    top_bit_ = 1;
+    while (top_bit_ * 2 <= size_) top_bit_ *= 2;
+
+    for (int s = 0; s < 2; ++s) {
+        volume_[s].assign(size_ + 1, 0);
+        notional_[s].assign(size_ + 1, 0);
+    }
+}
+
+Quantity DepthIndex::price_to_volume(Side side, Price price) const noexcept
+{
+    // Everything on the far side of the window counts as "better"
+    if (side == Side::Buy ? price > hi_ : price < lo_) return 0;
+    price = std::clamp(price, lo_, hi_);
+
+    const auto& tree = volume_[static_cast<int>(side)];
+    Quantity sum = 0;
+    for (std::size_t i = rank(side, price); i > 0; i -= i & (~i + 1)) {
+        sum += tree[i];
+    }
+    return sum;
+}
+
+std::size_t DepthIndex::descend(int s, Quantity qty, Quantity& volume, Quantity& notional) const noexcept
+{
+    // Fenwick binary lifting; valid because level volumes are never negative
+    std::size_t pos = 0;
+    volume = 0;
+    notional = 0;
+    for (std::size_t step = top_bit_; step > 0; step >>= 1) {
+        const std::size_t next = pos + step;
+        if (next <= size_ && volume + volume_[s][next] < qty) {
+            pos = next;
+            volume   += volume_[s][next];
+            notional += notional_[s][next];
+        }
+    }
+    return pos;
+}
+
+std::optional<Price> DepthIndex::volume_to_price(Side side, Quantity qty) const noexcept
+{
+    if (qty <= 0) return std::nullopt;
+
+    Quantity volume;
+    Quantity notional;
+    const std::size_t pos = descend(static_cast<int>(side), qty, volume, notional);
+    if (pos == size_) return std::nullopt;   // not enough depth
+    return price_at(side, pos + 1);
+}
+
+SweepCost DepthIndex::vwap_for_quantity(Side side, Quantity qty) const noexcept
+{
+    SweepCost cost{};
+    if (qty <= 0) return cost;
+
+    const int s = static_cast<int>(side);
+    Quantity volume;
+    Quantity notional;
+    std::size_t pos = descend(s, qty, volume, notional);
+
+    if (pos == size_) {
+        // Depth runs out: take all of it, worst price is the deepest level
+        cost.filled   = volume;
+        cost.notional = notional;
+        if (volume > 0) {
+            pos = descend(s, volume, volume, notional);
+            cost.worst_price = price_at(side, pos + 1);
+        }
+        return cost;
+    }
+
+    // Levels [1, pos] are taken whole, the rest comes from level pos + 1
+    const Price last = price_at(side, pos + 1);
+    cost.filled      = qty;
+    cost.notional    = notional + (qty - volume) * last;
+    cost.worst_price = last;
+    return cost;
+}
+
+void DepthIndex::clear(Side side) noexcept
+{
+    const int s = static_cast<int>(side);
+    std::fill(volume_[s].begin(), volume_[s].end(), 0);
+    std::fill(notional_[s].begin(), notional_[s].end(), 0);
+}
+
+} // namespace lob
@@ -0,0 +1,219 @@
+#include "lob/flow_generator.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace lob {
+
+namespace {
+
+// ------------------------
+// Ziggurat tables for the standard exponential (Marsaglia & Tsang, 2000)
+// ------------------------
+// 256 layers of equal area V under exp(-x). Layer i spans [0, x[i]] and
+// heights f[i]..f[i + 1]; layer 0 is the base rectangle plus the tail past
+// R, stretched to width V / f(R). ~99% of draws are one table lookup.
+struct ExpZiggurat {
+    static constexpr double R = 7.69711747013104972;
+    static constexpr double V = 3.949659822581572e-3;
+
+    std::array<double, 257> x;
+    std::array<double, 257> f;
+
+    ExpZiggurat() noexcept
+    {
+        x[0] = V / std::exp(-R);
+        x[1] = R;
+        for (std::size_t i = 2; i < 256; ++i) {
+            x[i] = -std::log(V / x[i - 1] + std::exp(-x[i - 1]));
+        }
+        x[256] = 0.0;
+        for (std::size_t i = 0; i < 257; ++i) f[i] = std::exp(-x[i]);
+    }
+};
+
+// Built on first use, so generators constructed during static init work
+const ExpZiggurat& exp_ziggurat() noexcept
+{
+    static const ExpZiggurat z;
+    return z;
+}
+
+// Probability as a threshold on 32 random bits: p = 1 passes every draw
+uint64_t cut(double p) noexcept
+{
+    return static_cast<uint64_t>(std::clamp(p, 0.0, 1.0) * 0x1.0p32);
+}
+
+} // namespace
+
+FlowGenerator::FlowGenerator(const FlowConfig& config)
+    : config_(config),
+      rng_(config.seed),
+      rand_pos_(rand_.size()),
+      background_pos_(background_wait_.size()),
+      intensity_(config.base_rate),
+      inv_log_distance_(1.0 / std::log(1.0 - 1.0 / (1.0 + std::max(config.mean_distance, 1e-9)))),
+      mid_step_cut_(cut(config.mid_step_prob)),
+      marketable_cut_(cut(config.marketable_ratio)),
+      cancel_cut_(cut(config.cancel_ratio)),
+      modify_cut_(cut(config.modify_ratio)),
+      next_arrival_(config.start_ts),
+      mid_(config.initial_mid)
+{
+    advance_arrival();
+}
+
+HistoricalEvent FlowGenerator::next()
+{
+    // Timers due at or before the next arrival go first
+    if (!timers_.empty() && timers_.top_ts() <= next_arrival_) {
+        const Timer t = timers_.pop();
+        return HistoricalEvent{next_event_id_++, t.type, t.order_id, t.side, t.price, t.qty, t.ts};
+    }
+
+    HistoricalEvent e = new_order();
+    advance_arrival();
+    return e;
+}
+
+std::size_t FlowGenerator::generate(std::span<HistoricalEvent> out)
+{
+    for (auto& e : out) e = next();
+    return out.size();
+}
+
+FlowGenerator::Timer FlowGenerator::TimerQueue::pop()
+{
+    if (buckets_[0].empty()) {
+        // Advance to the smallest pending ts; everything in its bucket now
+        // differs from it in a lower bit, so it all moves to lower buckets
+        const auto b = 1 + static_cast<std::size_t>(std::countr_zero(occupied_));
+        last_ = mins_[b];
+        for (const Timer& t : buckets_[b]) {
+            const auto to = static_cast<std::size_t>(std::bit_width(t.ts ^ last_));
+            buckets_[to].push_back(t);
+            mins_[to] = std::min(mins_[to], t.ts);
+            if (to) occupied_ |= uint64_t{1} << (to - 1);
+        }
+        buckets_[b].clear();
+        mins_[b] = std::numeric_limits<Timestamp>::max();
+        occupied_ &= ~(uint64_t{1} << (b - 1));
+    }
+
+    const Timer t = buckets_[0].back();
+    buckets_[0].pop_back();
+    --size_;
+    return t;
+}
+
+double FlowGenerator::exponential() noexcept
+{
+    const ExpZiggurat& z = exp_ziggurat();
+    for (;;) {
+        const uint64_t b = bits();
+        const std::size_t i = b & 0xFF;
+        const double x = static_cast<double>(b >> 11) * 0x1.0p-53 * z.x[i];
+        if (x < z.x[i + 1]) return x;
+        if (i == 0) return ExpZiggurat::R - std::log(uniform());
+        if (z.f[i + 1] + (z.f[i] - z.f[i + 1]) * uniform() < std::exp(-x)) return x;
+    }
+}
+
+void FlowGenerator::refill_background()
+{
+    const double mu = config_.base_rate;
+    for (auto& w : background_wait_) w = exponential() / mu;
+
+    // Without excitation the intensity never leaves mu: no decay needed
+    if (config_.excitation > 0.0) {
+        for (std::size_t i = 0; i < background_wait_.size(); ++i) {
+            background_decay_[i] = std::exp(-config_.decay * background_wait_[i]);
+        }
+    }
+    background_pos_ = 0;
+}
+
+void FlowGenerator::advance_arrival()
+{
+    // Exact simulation of an exponential-kernel Hawkes process: the next
+    // arrival is the earlier of the excited part's next event (which may
+    // never come) and the background Poisson event.
+    if (background_pos_ == background_wait_.size()) refill_background();
+
+    const double mu     = config_.base_rate;
+    const double excess = intensity_ - mu;
+
+    double wait  = background_wait_[background_pos_];
+    double decay = background_decay_[background_pos_];
+    ++background_pos_;
+
+    if (excess > 0.0) {
+        // The excited part fires at -log(d) / decay, so it comes first
+        // exactly when its decay factor d beats the background's
+        const double d = 1.0 - config_.decay * exponential() / excess;
+        if (d > decay) {
+            wait  = -std::log(d) / config_.decay;
+            decay = d;
+        }
+    }
+
+    intensity_ = mu + excess * decay + config_.excitation;
+    next_arrival_ += static_cast<Timestamp>(wait * 1e9);
+}
+
+HistoricalEvent FlowGenerator::new_order()
+{
+    // Four words per order: each coin flip and bounded integer takes 32
+    // bits of one, flags take single bits of the last
+    const uint64_t coins  = bits();   // mid step | marketable
+    const uint64_t sizes  = bits();   // quantity | owner
+    const uint64_t timers = bits();   // cancels  | modifies
+    const uint64_t flags  = bits();
+
+    if ((coins >> 32) < mid_step_cut_) {
+        mid_ += (flags & 1) ? 1 : -1;
+    }
+
+    const Side side = (flags & 2) ? Side::Buy : Side::Sell;
+    const auto distance = static_cast<Price>(-exponential() * inv_log_distance_);
+
+    // Passive orders rest `distance` ticks behind their touch (mid -/+ 1);
+    // marketable ones reach through to the other side
+    const Price sign = (side == Side::Buy) ? 1 : -1;
+    const Price price = (coins & 0xFFFF'FFFF) < marketable_cut_
+                            ? mid_ + sign * (1 + distance)
+                            : mid_ - sign * (1 + distance);
+
+    const auto range = static_cast<uint64_t>(config_.max_qty - config_.min_qty + 1);
+    const Quantity qty = config_.min_qty + static_cast<Quantity>(((sizes >> 32) * range) >> 32);
+
+    const ParticipantId owner = config_.participants
+        ? 1 + static_cast<ParticipantId>(((sizes & 0xFFFF'FFFF) * config_.participants) >> 32)
+        : 0;
+
+    const OrderId id = next_order_id_++;
+    const Timestamp ts = next_arrival_;
+
+    // Schedule this order's future: a modify somewhere in its life, a cancel at the end
+    const bool cancels  = (timers >> 32) < cancel_cut_;
+    const bool modifies = (timers & 0xFFFF'FFFF) < modify_cut_;
+    if (cancels || modifies) {
+        const double life = exponential() * config_.mean_lifetime_ns;
+        if (modifies) {
+            const auto at = ts + static_cast<Timestamp>(life * uniform());
+            if (flags & 4) {
+                timers_.push({at, id, price, std::max<Quantity>(1, qty / 2), side, EventType::MODIFY});
+            } else {
+                timers_.push({at, id, price - sign, qty, side, EventType::MODIFY});   // step back a tick
+            }
+        }
+        if (cancels) {
+            timers_.push({ts + static_cast<Timestamp>(life) + 1, id, price, 0, side, EventType::CANCEL});
+        }
+    }
+
+    return HistoricalEvent{next_event_id_++, EventType::LIMIT, id, side, price, qty, ts, owner};
+}
+
+} // namespace lob
@@ -1,20 +1,81 @@
+#include <cstdlib>
 #include <iostream>
 #include "lob/matching_engine.hpp"
 
 namespace lob {
 
-MatchingEngine::MatchingEngine(std::size_t pool_size)
-    : book_(pool_size)
+MatchingEngine::MatchingEngine(std::size_t pool_size, std::pmr::memory_resource* mr)
+    : perf(mr, kLatencyWindow), book_(pool_size, mr), scratch_(mr)
 {}
 
 std::vector<TradeEvent> MatchingEngine::match_limit_order(Order* incoming)
+{
+    scratch_.clear();
+    match_limit_order(incoming, scratch_);
+    return {scratch_.begin(), scratch_.end()};
+}
+
+RiskEngine& MatchingEngine::enable_risk_checks(std::size_t max_accounts)
+{
+    risk_ = std::make_unique<RiskEngine>(book_, max_accounts, book_.resource());
+    return *risk_;
+}
+
+template<TradeSink B>
+void MatchingEngine::match_limit_order(Order* incoming, B& events)
+{
+    submit_limit_order(incoming, events);
+}
+
+template<TradeSink B>
+RiskResult MatchingEngine::submit_limit_order(Order* incoming, B& events)
+{
+    if (risk_) {
+        risk_->apply_kills();
+        if (incoming->owner != 0) {
+            const RiskResult r = risk_->check_order(*incoming);
+            if (r != RiskResult::Accepted) {
+                book_.pool().deallocate(incoming);
+                return r;
+            }
+        }
+    }
+
+    execute(incoming, events);
+    return RiskResult::Accepted;
+}
+
+template<TradeSink B>
+void MatchingEngine::execute(Order* incoming, B& events)
 {
     auto start = std::chrono::high_resolution_clock::now();
+    const std::size_t first_trade = events.size();
 
-    std::vector<TradeEvent> events;
+    if (mode_ == MatchingMode::Auction) {
+        // Accumulate only; executions happen at uncross()
+        book_.insert_into_level(incoming);
+        book_.order_index().emplace(incoming->id, incoming);
+    } else if (incoming->side == Side::Buy) {
+        // The only side branch: everything below is specialised per side
+        match<Side::Buy, B>(incoming, events);
+    } else {
+        match<Side::Sell, B>(incoming, events);
+    }
+    if (risk_ && events.size() > first_trade) risk_->on_trade(events.back().price);
 
-    // Determine opposite book to match
-    auto& opposite_book = (incoming->side == Side::Buy) ? book_.asks() : book_.bids();
+    auto end = std::chrono::high_resolution_clock::now();
+    double us = std::chrono::duration<double, std::micro>(end - start).count();
+    perf.record(us);
+}
+
+template<Side S, TradeSink B>
+void MatchingEngine::match(Order* incoming, B& events)
+{
+    using Own = BookSide<S>;
+    constexpr Side Opposite = Own::opposite;
+
+    // Opposite levels run best first
+    auto& opposite_book = book_.levels<Opposite>();
 
     auto it = opposite_book.begin();
 
@@ -22,9 +83,7 @@ std::vector<TradeEvent> MatchingEngine::match_limit_order(Order* incoming)
         PriceLevel& level = it->second;
 
         // Check if price crosses
-        bool cross = (incoming->side == Side::Buy) ? (incoming->price >= level.price)
-                                                   : (incoming->price <= level.price);
-        if (!cross) break;
+        if (!Own::crosses(incoming->price, level.price)) break;
 
         // Store next iterator BEFORE potentially erasing this price level
         auto next_it = std::next(it);
@@ -39,10 +98,32 @@ std::vector<TradeEvent> MatchingEngine::match_limit_order(Order* incoming)
                 break;
             }
 
+            // Self-trade prevention: same (non-anonymous) owner on both sides
+            if (stp_ != SelfTradePrevention::None && incoming->owner != 0
+                && resting->owner == incoming->owner) {
+                if (stp_ == SelfTradePrevention::CancelNewest) {
+                    incoming->remaining = 0;   // drop the rest of the incoming order
+                    break;
+                }
+
+                Order* next_resting = resting->next;
+                if (stp_ == SelfTradePrevention::DecrementBoth) {
+                    // Reduce both sides by the would-be fill, no trade
+                    incoming->remaining -= executed_qty;
+                    book_.on_fill(level, resting, executed_qty);
+                }
+                if (stp_ == SelfTradePrevention::CancelOldest || resting->remaining == 0) {
+                    book_.remove_from_level<Opposite>(resting);
+                    book_.order_index().erase(resting->id);
+                    book_.pool().deallocate(resting);
+                }
+                resting = next_resting;
+                continue;
+            }
+
             // Update quantities
             incoming->remaining -= executed_qty;
-            resting->remaining -= executed_qty;
-            level.total_volume -= executed_qty;
+            book_.on_fill(level, resting, executed_qty);
 
             // Record trade
             events.push_back({resting->id, incoming->id, resting->price, executed_qty, incoming->ts});
@@ -50,9 +131,9 @@ std::vector<TradeEvent> MatchingEngine::match_limit_order(Order* incoming)
             Order* next_resting = resting->next;
 
             if (resting->remaining == 0) {
-                book_.remove_from_level(resting);        // remove from price level
-                book_.order_index().erase(resting->id); // remove from index
-                book_.pool().deallocate(resting);       // free memory
+                book_.remove_from_level<Opposite>(resting);  // remove from price level
+                book_.order_index().erase(resting->id);     // remove from index
+                book_.pool().deallocate(resting);           // free memory
             }
 
             resting = next_resting;
@@ -64,18 +145,194 @@ std::vector<TradeEvent> MatchingEngine::match_limit_order(Order* incoming)
 
     // If incoming still has remaining quantity, insert into book
     if (incoming->remaining > 0) {
-        book_.insert_into_level(incoming);
+        book_.insert_into_level<S>(incoming);
         book_.order_index().emplace(incoming->id, incoming);
     } else {
         // Fully executed, deallocate
         book_.pool().deallocate(incoming);
     }
+}
 
-    auto end = std::chrono::high_resolution_clock::now();
-    double us = std::chrono::duration<double, std::micro>(end - start).count();
-    perf.record(us);
+template<TradeSink B>
+bool MatchingEngine::modify_order(OrderId id, Price new_price, Quantity new_qty, Timestamp ts,
+                                  B& events)
+{
+    // Kills first: their cancels reshuffle the index, and may take this order
+    if (risk_) risk_->apply_kills();
+
+    auto& idx = book_.order_index();
+    auto it = idx.find(id);
+    if (it == idx.end()) return false;
+
+    Order* order = it->second;
+
+    if (risk_ && order->owner != 0
+        && risk_->check_modify(*order, new_price, new_qty, ts) != RiskResult::Accepted) {
+        return false;
+    }
+
+    // Size-downs, cancels and non-crossing requeues never need the matcher
+    bool crosses = false;
+    if (new_price != order->price && new_qty > 0 && mode_ == MatchingMode::Continuous) {
+        if (order->side == Side::Buy) {
+            const PriceLevel* touch = AskSide::best(book_.asks());
+            crosses = touch && BidSide::crosses(new_price, touch->price);
+        } else {
+            const PriceLevel* touch = BidSide::best(book_.bids());
+            crosses = touch && AskSide::crosses(new_price, touch->price);
+        }
+    }
 
-    return events;
+    if (!crosses) {
+        if (new_price != order->price || new_qty > order->remaining) {
+            order->ts = ts;   // requeued: new time priority
+        }
+        return book_.modify_order(id, new_price, new_qty);
+    }
+
+    // Crossing requeue: pull it out and match it like a new order
+    book_.remove_from_level(order);
+    idx.erase(id);
+
+    order->price     = new_price;
+    order->qty       = new_qty;
+    order->remaining = new_qty;
+    order->ts        = ts;
+
+    execute(order, events);   // already risk-checked above
+    return true;
+}
+
+// ---------------- Call auction ----------------
+
+AuctionEquilibrium MatchingEngine::indicative() const
+{
+    const auto& bids = book_.bids();
+    const auto& asks = book_.asks();
+
+    AuctionEquilibrium best{};
+    if (bids.empty() || asks.empty()) return best;
+
+    const Price best_bid = bids.begin()->first;
+    const Price best_ask = asks.begin()->first;
+    if (best_bid < best_ask) return best;   // not crossed
+
+    // Only levels inside [best_ask, best_bid] can trade. Walk both sides
+    // upwards over that range (bids in reverse, from the deepest crossed
+    // level): cumulative ask volume at or below p grows, cumulative bid
+    // volume at or above p shrinks.
+    auto ask_it = asks.begin();
+    const auto crossed_bids_end = bids.upper_bound(best_ask);
+    auto bid_it = std::make_reverse_iterator(crossed_bids_end);
+    const auto bids_end = bids.rend();
+
+    Quantity bid_at_or_above = 0;
+    for (auto it = bids.begin(); it != crossed_bids_end; ++it) bid_at_or_above += it->second.total_volume;
+    Quantity ask_at_or_below = 0;
+
+    Price tie_lo = 0;
+    Price tie_hi = 0;
+    Quantity tie_hi_imbalance = 0;
+
+    while ((ask_it != asks.end() && ask_it->first <= best_bid) || bid_it != bids_end) {
+        // Next candidate price is the lower of the two level prices
+        Price p = best_bid;
+        if (ask_it != asks.end() && ask_it->first <= best_bid) p = std::min(p, ask_it->first);
+        if (bid_it != bids_end) p = std::min(p, bid_it->first);
+
+        while (ask_it != asks.end() && ask_it->first <= p) {
+            ask_at_or_below += ask_it->second.total_volume;
+            ++ask_it;
+        }
+
+        Quantity volume = std::min(bid_at_or_above, ask_at_or_below);
+        Quantity imbalance = bid_at_or_above - ask_at_or_below;
+
+        if (!best.crossed || volume > best.volume
+            || (volume == best.volume && std::abs(imbalance) < std::abs(best.imbalance))) {
+            best = AuctionEquilibrium{true, p, volume, imbalance};
+            tie_lo = tie_hi = p;
+            tie_hi_imbalance = imbalance;
+        } else if (volume == best.volume && std::abs(imbalance) == std::abs(best.imbalance)) {
+            tie_hi = p;
+            tie_hi_imbalance = imbalance;
+        }
+
+        // Bids at exactly p stop counting for higher candidates
+        while (bid_it != bids_end && bid_it->first <= p) {
+            bid_at_or_above -= bid_it->second.total_volume;
+            ++bid_it;
+        }
+
+        if (p == best_bid) break;
+    }
+
+    // Remaining ties: lean towards the surplus side (market pressure).
+    // The surplus can flip sign across the tie, so report it at the
+    // price actually chosen.
+    if (best.imbalance > 0) {
+        best.price = tie_hi;
+        best.imbalance = tie_hi_imbalance;
+    } else {
+        best.price = tie_lo;
+    }
+    return best;
 }
 
-} // namespace lob
\ No newline at end of file
+std::vector<TradeEvent> MatchingEngine::uncross(Timestamp ts)
+{
+    scratch_.clear();
+    uncross(ts, scratch_);
+    return {scratch_.begin(), scratch_.end()};
+}
+
+template<TradeSink B>
+void MatchingEngine::uncross(Timestamp ts, B& events)
+{
+    const AuctionEquilibrium eq = indicative();
+    if (!eq.crossed) return;
+    if (risk_) risk_->on_trade(eq.price);
+
+    auto& bids = book_.bids();
+    auto& asks = book_.asks();
+
+    // Pair the best bid and best ask queues head to head until the
+    // equilibrium volume is done; both stay marketable at eq.price.
+    Quantity left = eq.volume;
+    while (left > 0) {
+        PriceLevel& bid_level = bids.begin()->second;
+        PriceLevel& ask_level = asks.begin()->second;
+        Order* bid = bid_level.head;
+        Order* ask = ask_level.head;
+
+        Quantity qty = std::min({left, bid->remaining, ask->remaining});
+        book_.on_fill(bid_level, bid, qty);
+        book_.on_fill(ask_level, ask, qty);
+        left -= qty;
+
+        // The earlier arrival is reported as the resting side
+        const bool bid_first = bid->seq < ask->seq;
+        events.push_back({bid_first ? bid->id : ask->id,
+                          bid_first ? ask->id : bid->id,
+                          eq.price, qty, ts});
+
+        for (Order* o : {bid, ask}) {
+            if (o->remaining == 0) {
+                book_.remove_from_level(o);
+                book_.order_index().erase(o->id);
+                book_.pool().deallocate(o);
+            }
+        }
+    }
+}
+
+template void MatchingEngine::match_limit_order(Order*, std::vector<TradeEvent>&);
+template void MatchingEngine::match_limit_order(Order*, TradeBuffer&);
+template RiskResult MatchingEngine::submit_limit_order(Order*, std::vector<TradeEvent>&);
+template RiskResult MatchingEngine::submit_limit_order(Order*, TradeBuffer&);
+template bool MatchingEngine::modify_order(OrderId, Price, Quantity, Timestamp, std::vector<TradeEvent>&);
+template bool MatchingEngine::modify_order(OrderId, Price, Quantity, Timestamp, TradeBuffer&);
+template void MatchingEngine::uncross(Timestamp, std::vector<TradeEvent>&);
+template void MatchingEngine::uncross(Timestamp, TradeBuffer&);
+
+} // namespace lob
@@ -1,13 +1,20 @@
 #include "lob/order_book.hpp"
+#include <algorithm>
 #include <iostream>
 
 namespace lob {
 
 // ---------------- Constructor ----------------
 
-OrderBook::OrderBook(std::size_t pool_size)
-    : pool_(pool_size)
+OrderBook::OrderBook(std::size_t pool_size, std::pmr::memory_resource* mr)
+    : bids_(mr),
+      asks_(mr),
+      order_index_(mr),
+      participants_(mr),
+      scratch_(mr),
+      pool_(pool_size, mr)
 {
+    order_index_.reserve(pool_size);
 }
 
 // ---------------- Public API ----------------
@@ -17,7 +24,8 @@ Order* OrderBook::add_limit_order_no_match(
     Side side,
     Price price,
     Quantity qty,
-    Timestamp ts)
+    Timestamp ts,
+    ParticipantId owner)
 {
     // Allocate from pool
     Order* order = pool_.allocate();
@@ -31,6 +39,7 @@ Order* OrderBook::add_limit_order_no_match(
     order->qty       = qty;
     order->remaining = qty;
     order->side      = side;
+    order->owner     = owner;
     order->ts        = ts;
     order->next      = nullptr;
     order->prev      = nullptr;
@@ -63,12 +72,123 @@ bool OrderBook::cancel_order(OrderId id)
     return true;
 }
 
+std::size_t OrderBook::cancel_participant(ParticipantId owner)
+{
+    auto it = participants_.find(owner);
+    if (it == participants_.end()) return 0;
+
+    std::size_t cancelled = 0;
+    Order* order = it->second.head;
+    while (order) {
+        Order* next = order->owner_next;
+
+        remove_from_level(order);   // also unlinks from the participant list
+        order_index_.erase(order->id);
+        pool_.deallocate(order);
+
+        ++cancelled;
+        order = next;
+    }
+    return cancelled;
+}
+
+std::size_t OrderBook::cancel_side(Side side)
+{
+    if (side == Side::Buy) {
+        return release_levels(Side::Buy, bids_, bids_.begin(), bids_.end());
+    }
+    return release_levels(Side::Sell, asks_, asks_.begin(), asks_.end());
+}
+
+std::size_t OrderBook::cancel_at_or_beyond(Side side, Price price)
+{
+    // Levels run best first, so "at or beyond" is a tail on either side
+    if (side == Side::Buy) {
+        return release_levels(Side::Buy, bids_, bids_.lower_bound(price), bids_.end());
+    }
+    return release_levels(Side::Sell, asks_, asks_.lower_bound(price), asks_.end());
+}
+
+std::size_t OrderBook::cancel_orders(std::span<const OrderId> ids)
+{
+    constexpr std::size_t kAhead = 8;
+
+    // Pull every order out of the index first, warming the table a few ids
+    // ahead (a repeated id misses the second time)
+    scratch_.clear();
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        if (i + kAhead < ids.size()) order_index_.prefetch(ids[i + kAhead]);
+        auto it = order_index_.find(ids[i]);
+        if (it == order_index_.end()) continue;
+        scratch_.push_back(it->second);
+        order_index_.erase(it);
+    }
+    if (scratch_.empty()) return 0;
+
+    // Unlink from the FIFOs; only the level's counters move per order. The
+    // order that empties a level is parked at the front of scratch_, so each
+    // emptied level leaves the map once and each listener fires once per side.
+    const PriceLevel* top[2] = {bids_.empty() ? nullptr : &bids_.begin()->second,
+                                asks_.empty() ? nullptr : &asks_.begin()->second};
+    bool top_changed[2] = {false, false};
+    std::size_t emptied = 0;
+
+    for (std::size_t i = 0; i < scratch_.size(); ++i) {
+        if (i + kAhead < scratch_.size()) __builtin_prefetch(scratch_[i + kAhead]);
+
+        Order* order = scratch_[i];
+        PriceLevel* level = order->level;
+        order->level = nullptr;
+
+        if (order->prev) order->prev->next = order->next;
+        if (order->next) order->next->prev = order->prev;
+        if (level->head == order) level->head = order->next;
+        if (level->tail == order) level->tail = order->prev;
+
+        level->total_volume -= order->remaining;
+        total_volume_       -= order->remaining;
+        --level->order_count;
+        if (depth_) depth_->add(order->side, level->price, -order->remaining);
+
+        if (level->tracked_head) release_queue_ahead(*level, order, order->remaining, 1);
+        if (order->account) unlink_participant(order);
+
+        const std::size_t s = static_cast<std::size_t>(order->side);
+        top_changed[s] |= (level == top[s]);
+        if (level->head == nullptr) std::swap(scratch_[emptied++], scratch_[i]);
+    }
+
+    for (std::size_t i = 0; i < emptied; ++i) {
+        const Order* last = scratch_[i];
+        if (last->side == Side::Buy) bids_.erase(last->price);
+        else asks_.erase(last->price);
+    }
+
+    if (top_listener_) {
+        if (top_changed[0]) top_listener_(Side::Buy);
+        if (top_changed[1]) top_listener_(Side::Sell);
+    }
+
+    for (Order* o : scratch_) pool_.deallocate(o);
+    return scratch_.size();
+}
+
 bool OrderBook::modify_order(OrderId id, Price new_price, Quantity new_qty) {
     auto it = order_index_.find(id);
     if (it == order_index_.end()) return false;
 
     Order* order = it->second;
 
+    if (new_qty <= 0) {
+        return cancel_order(id);
+    }
+
+    // Fast path: same price, smaller size -> adjust in place, keep priority
+    if (new_price == order->price && new_qty <= order->remaining) {
+        reduce_order(order, order->remaining - new_qty);   // qty keeps the original size
+        return true;
+    }
+
     // Remove from current level
     remove_from_level(order);
 
@@ -103,58 +223,103 @@ std::size_t OrderBook::size() const noexcept
     return order_index_.size();
 }
 
+const ParticipantState* OrderBook::participant(ParticipantId owner) const
+{
+    auto it = participants_.find(owner);
+    return it == participants_.end() ? nullptr : &it->second;
+}
+
+void OrderBook::enable_depth_index(Price lo, Price hi)
+{
+    depth_ = std::make_unique<DepthIndex>(lo, hi, resource());
+    for (const auto& [price, level] : bids_) depth_->add(Side::Buy, price, level.total_volume);
+    for (const auto& [price, level] : asks_) depth_->add(Side::Sell, price, level.total_volume);
+}
+
+std::optional<QueuePosition> OrderBook::queue_position(OrderId id) const
+{
+    auto it = order_index_.find(id);
+    if (it == order_index_.end() || !it->second->tracked) {
+        return std::nullopt;
+    }
+    const Order* order = it->second;
+    return QueuePosition{order->orders_ahead, order->volume_ahead};
+}
+
+bool OrderBook::track_queue(OrderId id)
+{
+    auto it = order_index_.find(id);
+    if (it == order_index_.end()) return false;
+
+    Order* order = it->second;
+    if (order->tracked) return true;
+
+    if (!order->level) return false;
+    PriceLevel& level = *order->level;
+
+    // One walk to seed the counters; maintained incrementally afterwards
+    order->orders_ahead = 0;
+    order->volume_ahead = 0;
+    for (const Order* o = level.head; o != order; o = o->next) {
+        ++order->orders_ahead;
+        order->volume_ahead += o->remaining;
+    }
+
+    order->tracked      = true;
+    order->next_tracked = level.tracked_head;
+    level.tracked_head  = order;
+    return true;
+}
+
 // ---------------- Internal Helpers ----------------
 
+template<Side S>
 void OrderBook::insert_into_level(Order* order)
 {
-    auto& book_side = (order->side == Side::Buy) ? bids_ : asks_;
-    auto it = book_side.find(order->price);
+    total_volume_ += order->remaining;
+    order->seq = next_seq_++;
 
-    if (it == book_side.end()) {
-        // Create new price level
-        PriceLevel level{};
-        level.price        = order->price;
-        level.total_volume = order->remaining;
-        level.head         = order;
-        level.tail         = order;
+    auto [it, created] = levels<S>().try_emplace(order->price);
+    PriceLevel& level = it->second;
+    order->level = &level;
 
-        book_side.emplace(order->price, level);
+    if (created) {
+        // New price level
+        level.price = order->price;
+    }
+
+    if (order->tracked) {
+        // Everything already queued here is ahead of the new order
+        order->orders_ahead = level.order_count;
+        order->volume_ahead = level.total_volume;
+        order->next_tracked = level.tracked_head;
+        level.tracked_head  = order;
+    }
+
+    // Append to tail
+    order->prev = level.tail;
+    order->next = nullptr;
+    if (level.tail) {
+        level.tail->next = order;
     } else {
-        PriceLevel& level = it->second;
-
-        if (!level.tail) {
-            // Level exists but empty — treat as new
-            level.head = order;
-            level.tail = order;
-            level.total_volume = order->remaining;
-            order->prev = nullptr;
-            order->next = nullptr;
-        } else {
-            // Append to existing tail
-            order->prev = level.tail;
-            level.tail->next = order;
-            level.tail = order;
-            level.total_volume += order->remaining;
-            order->next = nullptr;
-        }
+        level.head = order;
     }
+    level.tail = order;
+    level.total_volume += order->remaining;
+    ++level.order_count;
+    if (depth_) depth_->add(S, order->price, order->remaining);
+    if (top_listener_ && it == levels<S>().begin()) top_listener_(S);
+
+    if (order->owner != 0) link_participant(order);
 }
 
+template<Side S>
 void OrderBook::remove_from_level(Order* order)
 {
-    if (!order) return;
+    if (!order || !order->level) return;   // not resting
 
-    PriceLevel* level = nullptr;
-
-    if (order->side == Side::Buy) {
-        auto it = bids_.find(order->price);
-        if (it == bids_.end()) return;
-        level = &it->second;
-    } else {
-        auto it = asks_.find(order->price);
-        if (it == asks_.end()) return;
-        level = &it->second;
-    }
+    PriceLevel* level = order->level;
+    order->level = nullptr;
 
     // Remove from linked list
     if (order->prev) order->prev->next = order->next;
@@ -164,17 +329,165 @@ void OrderBook::remove_from_level(Order* order)
     if (level->tail == order) level->tail = order->prev;
 
     level->total_volume -= order->remaining;
+    total_volume_       -= order->remaining;
+    --level->order_count;
+    if (depth_) depth_->add(S, level->price, -order->remaining);
+
+    if (level->tracked_head) release_queue_ahead(*level, order, order->remaining, 1);
+    if (order->account) unlink_participant(order);
+
+    const bool was_top = top_listener_ && &levels<S>().begin()->second == level;
 
     // If the level is now empty, erase it from the map
     if (level->head == nullptr) {
-        if (order->side == Side::Buy) {
-            bids_.erase(order->price);
+        levels<S>().erase(order->price);
+    }
+
+    if (was_top) top_listener_(S);
+
+    // At this point, the level is safely removed if empty
+}
+
+template void OrderBook::insert_into_level<Side::Buy>(Order*);
+template void OrderBook::insert_into_level<Side::Sell>(Order*);
+template void OrderBook::remove_from_level<Side::Buy>(Order*);
+template void OrderBook::remove_from_level<Side::Sell>(Order*);
+
+template<typename Levels>
+std::size_t OrderBook::release_levels(Side side, Levels& levels, typename Levels::iterator first,
+                                      typename Levels::iterator last)
+{
+    if (first == last) return 0;
+
+    std::size_t cancelled = 0;
+    for (auto it = first; it != last; ++it) {
+        // Tracked orders leave with their level; no one behind them to credit
+        total_volume_ -= it->second.total_volume;
+        cancelled     += it->second.order_count;
+    }
+
+    if (depth_) {
+        if (first == levels.begin() && last == levels.end()) {
+            depth_->clear(side);   // whole side: one reset, not one update per level
         } else {
-            asks_.erase(order->price);
+            for (auto it = first; it != last; ++it) {
+                depth_->add(side, it->first, -it->second.total_volume);
+            }
         }
     }
 
-    // At this point, the level is safely removed if empty
+    // The whole book going at once: drop the index in one pass instead of
+    // entry by entry
+    const bool whole_book = (cancelled == order_index_.size());
+    if (whole_book) order_index_.clear();
+
+    // Walk only the detached FIFOs, a few levels at a time so the misses on
+    // their (independent) chains overlap instead of queueing behind each
+    // other. Index erases trail the walk by kDelay orders, so the slot each
+    // one needs has been prefetched by the time it runs.
+    constexpr std::size_t kLanes = 8;
+    constexpr std::size_t kDelay = 16;
+    Order* lane[kLanes];
+    Order* pending[kDelay];
+    std::size_t seen = 0;
+
+    auto release = [&](Order* o) {
+        if (o->account) unlink_participant(o);
+        if (!whole_book) order_index_.erase(o->id);
+        pool_.deallocate(o);
+    };
+
+    auto it = first;
+    while (it != last) {
+        std::size_t lanes = 0;
+        for (; lanes < kLanes && it != last; ++it) {
+            if (it->second.head) lane[lanes++] = it->second.head;   // levels are never empty, but skip if so
+        }
+
+        for (std::size_t live = lanes; live > 0;) {
+            live = 0;
+            for (std::size_t l = 0; l < lanes; ++l) {
+                Order* o = lane[l];
+                if (!o) continue;
+                lane[l] = o->next;
+                if (o->next) {
+                    __builtin_prefetch(o->next);
+                    ++live;
+                }
+                if (!whole_book) order_index_.prefetch(o->id);
+
+                Order*& slot = pending[seen++ % kDelay];
+                if (seen > kDelay) release(slot);
+                slot = o;
+            }
+        }
+    }
+    for (std::size_t i = seen > kDelay ? seen - kDelay : 0; i < seen; ++i) {
+        release(pending[i % kDelay]);
+    }
+
+    const bool was_top = (first == levels.begin());
+    levels.erase(first, last);
+    if (top_listener_ && was_top) top_listener_(side);
+    return cancelled;
+}
+
+void OrderBook::release_queue_ahead(PriceLevel& level, const Order* order,
+                                    Quantity qty, std::size_t orders) noexcept
+{
+    Order** link = &level.tracked_head;
+    while (Order* t = *link) {
+        if (t == order) {
+            if (orders) {
+                // Leaving the level: stop tracking here
+                *link = t->next_tracked;
+                t->next_tracked = nullptr;
+                continue;
+            }
+        } else if (order->seq < t->seq) {
+            t->volume_ahead -= qty;
+            t->orders_ahead -= orders;
+        }
+        link = &t->next_tracked;
+    }
+}
+
+void OrderBook::link_participant(Order* order)
+{
+    ParticipantState& account = participants_[order->owner];
+
+    order->account    = &account;
+    order->owner_prev = nullptr;
+    order->owner_next = account.head;
+    if (account.head) account.head->owner_prev = order;
+    account.head = order;
+
+    ++account.open_orders;
+    if (order->side == Side::Buy) {
+        account.open_buy_qty += order->remaining;
+    } else {
+        account.open_sell_qty += order->remaining;
+    }
+    account.open_notional += order->price * order->remaining;
+}
+
+void OrderBook::unlink_participant(Order* order) noexcept
+{
+    ParticipantState& account = *order->account;
+
+    release_exposure(account, order, order->remaining);
+    --account.open_orders;
+
+    if (order->owner_prev) {
+        order->owner_prev->owner_next = order->owner_next;
+    } else {
+        account.head = order->owner_next;
+    }
+    if (order->owner_next) order->owner_next->owner_prev = order->owner_prev;
+
+    order->account    = nullptr;
+    order->owner_next = nullptr;
+    order->owner_prev = nullptr;
 }
 
-} // namespace lob
\ No newline at end of file
+} // namespace lob
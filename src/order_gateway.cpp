@@ -0,0 +1,161 @@
+#include "lob/order_gateway.hpp"
+#include <algorithm>
+
+namespace lob {
+
+OrderId OrderGateway::submit_limit(Side side, Price price, Quantity qty)
+{
+    OrderId id = next_id_++;
+    pending_.push(Command{now_ + latency_, next_seq_++, Command::Kind::Submit, id, side, price, qty});
+    return id;
+}
+
+void OrderGateway::cancel(OrderId id)
+{
+    pending_.push(Command{now_ + latency_, next_seq_++, Command::Kind::Cancel, id, Side::Buy, 0, 0});
+}
+
+void OrderGateway::advance_to(Timestamp ts, TradeBuffer& trades)
+{
+    while (!pending_.empty() && pending_.top().arrival < ts) {
+        Command cmd = pending_.top();
+        pending_.pop();
+        execute(cmd, trades);
+    }
+    now_ = ts;
+}
+
+void OrderGateway::flush(TradeBuffer& trades)
+{
+    while (!pending_.empty()) {
+        Command cmd = pending_.top();
+        pending_.pop();
+        if (cmd.arrival > now_) now_ = cmd.arrival;
+        execute(cmd, trades);
+    }
+}
+
+std::optional<QueuePosition> OrderGateway::queue_position(OrderId id) const
+{
+    if (mode_ == GatewayMode::Live) return engine_.book().queue_position(id);
+
+    auto it = find_shadow(id);
+    if (it == shadow_.end() || it->id != id) return std::nullopt;
+    return QueuePosition{0, it->ahead};
+}
+
+void OrderGateway::execute(const Command& cmd, TradeBuffer& trades)
+{
+    if (mode_ == GatewayMode::Shadow) {
+        if (cmd.kind == Command::Kind::Submit) {
+            shadow_submit(cmd, trades);
+        } else {
+            auto it = find_shadow(cmd.id);
+            if (it != shadow_.end() && it->id == cmd.id) shadow_.erase(it);
+        }
+        return;
+    }
+
+    switch (cmd.kind) {
+    case Command::Kind::Submit: {
+        Order* o = engine_.book().pool().allocate();
+        if (!o) return;   // pool exhausted
+        o->id        = cmd.id;
+        o->side      = cmd.side;
+        o->price     = cmd.price;
+        o->qty       = cmd.qty;
+        o->remaining = cmd.qty;
+        o->ts        = cmd.arrival;
+        o->owner     = owner_;
+        o->tracked   = true;
+
+        engine_.match_limit_order(o, trades);
+        break;
+    }
+    case Command::Kind::Cancel:
+        engine_.book().cancel_order(cmd.id);
+        break;
+    }
+}
+
+Quantity OrderGateway::level_volume(Side side, Price price) const
+{
+    const OrderBook& book = engine_.book();
+    if (side == Side::Buy) {
+        auto it = book.bids().find(price);
+        return it == book.bids().end() ? 0 : it->second.total_volume;
+    }
+    auto it = book.asks().find(price);
+    return it == book.asks().end() ? 0 : it->second.total_volume;
+}
+
+void OrderGateway::shadow_submit(const Command& cmd, TradeBuffer& trades)
+{
+    ShadowOrder s{cmd.id, cmd.side, cmd.price, cmd.qty, 0};
+
+    // Take the crossing liquidity level by level at its prices; the
+    // market's orders stay where they are
+    auto take = [&](const auto& levels, auto crosses) {
+        for (const auto& [price, level] : levels) {
+            if (s.remaining == 0 || !crosses(price)) break;
+            const Quantity q = std::min(s.remaining, level.total_volume);
+            trades.push_back(TradeEvent{0, s.id, price, q, cmd.arrival});
+            s.remaining -= q;
+        }
+    };
+    if (s.side == Side::Buy) {
+        take(engine_.book().asks(), [&](Price p) { return p <= s.price; });
+    } else {
+        take(engine_.book().bids(), [&](Price p) { return p >= s.price; });
+    }
+
+    if (s.remaining == 0) return;
+    s.ahead = level_volume(s.side, s.price);
+    shadow_.insert(find_shadow(s.id), s);   // ids rise, so this is an append unless latency changed
+}
+
+void OrderGateway::on_market_event(const HistoricalEvent& e, std::span<const TradeEvent> market,
+                                   TradeBuffer& fills)
+{
+    if (shadow_.empty()) return;
+
+    // What is left of the event's own order, resting on e.side
+    const Order* rest = nullptr;
+    if (e.type != EventType::CANCEL) {
+        auto it = engine_.book().order_index().find(e.order_id);
+        if (it != engine_.book().order_index().end()) rest = it->second;
+    }
+
+    auto fill = [&](ShadowOrder& s, OrderId against, Quantity q) {
+        q = std::min(q, s.remaining);
+        if (q == 0) return;
+        fills.push_back(TradeEvent{s.id, against, s.price, q, e.ts});
+        s.remaining -= q;
+    };
+
+    for (auto& s : shadow_) {
+        // Only an aggressor from the other side trades against s
+        if (s.side != e.side) {
+            const bool buy = s.side == Side::Buy;
+            for (const auto& t : market) {
+                if (t.price == s.price) {
+                    const Quantity eaten = std::min(t.quantity, s.ahead);
+                    s.ahead -= eaten;
+                    fill(s, t.incoming_order_id, t.quantity - eaten);
+                } else if (buy ? t.price < s.price : t.price > s.price) {
+                    fill(s, t.incoming_order_id, t.quantity);
+                }
+            }
+            if (rest && (buy ? rest->price <= s.price : rest->price >= s.price)) {
+                fill(s, rest->id, rest->remaining);
+            }
+        }
+
+        // Cancels and modifies may have taken volume from in front of s
+        if (e.type != EventType::LIMIT) s.ahead = std::min(s.ahead, level_volume(s.side, s.price));
+    }
+
+    std::erase_if(shadow_, [](const ShadowOrder& s) { return s.remaining == 0; });
+}
+
+} // namespace lob
@@ -1,73 +1,68 @@
 #include "lob/paper_trader.hpp"
-#include <algorithm>
+#include "lob/pipelined_replay.hpp"
 
 namespace lob {
 
 void PaperTradingEngine::feed_events(const std::vector<HistoricalEvent>& events)
 {
     for (const auto& e : events) {
-        switch (e.type) {
-        case EventType::LIMIT: {
-            auto* o = engine_.book().pool().allocate();
-            o->id = e.order_id;
-            o->side = e.side;
-            o->price = e.price;
-            o->qty = e.qty;
-            o->remaining = e.qty;
-            o->ts = e.ts;
-
-            auto event_trades = engine_.match_limit_order(o);
-            trades_.insert(trades_.end(), event_trades.begin(), event_trades.end());
-            break;
-        }
-        case EventType::CANCEL: {
-            auto& idx = engine_.book().order_index();
-            auto it = idx.find(e.order_id);
-            if (it != idx.end()) {
-                Order* o = it->second;
-                engine_.book().remove_from_level(o);
-                engine_.book().pool().deallocate(o);
-            }
-            break;
-        }
-        case EventType::MODIFY: {
-            auto& idx = engine_.book().order_index();
-            auto it = idx.find(e.order_id);
-            if (it != idx.end()) {
-                Order* o = it->second;
-                // Remove from old level
-                engine_.book().remove_from_level(o);
-                // Apply modification
-                o->price = e.price;
-                o->qty = e.qty;
-                o->remaining = e.qty;
-                o->ts = e.ts;
-                // Re-insert into book
-                auto event_trades = engine_.match_limit_order(o);
-                trades_.insert(trades_.end(), event_trades.begin(), event_trades.end());
-            }
-            break;
-        }
-        }
+        feed_event(e);
+    }
+}
 
-        // Capture analytics after each event
-        capture_snapshot(e.ts);
+void PaperTradingEngine::feed_events(const std::vector<HistoricalEvent>& events,
+                                     TradeBuffer& trades, AnalyticsBuffer& analytics)
+{
+    for (const auto& e : events) {
+        replay_one(engine_, e, trades, analytics, strategy_);
     }
 }
 
-void PaperTradingEngine::capture_snapshot(Timestamp ts)
+void PaperTradingEngine::feed_event(const HistoricalEvent& e)
 {
-    // Simplest analytics: mid-price & total volume
-    auto& book = engine_.book();
-    Price best_bid = book.bids().empty() ? 0 : book.bids().begin()->first;
-    Price best_ask = book.asks().empty() ? 0 : book.asks().begin()->first;
+    // Match, capture analytics and notify the strategy
+    replay_one(engine_, e, trades_, analytics_, strategy_);
+}
+
+void PaperTradingEngine::replay_event(const HistoricalEvent& evt)
+{
+    switch (evt.type) {
+    case EventType::LIMIT: {
+        Order* o = engine_.book().pool().allocate();
+        if (!o) break;   // pool exhausted
+        o->id = evt.id;
+        o->side = evt.side;
+        o->price = evt.price;
+        o->qty = evt.qty;
+        o->remaining = evt.qty;
+        o->owner = evt.participant;
+        o->ts = evt.ts;
 
-    Quantity total_volume = 0;
-    for (const auto& [price, level] : book.bids()) total_volume += level.total_volume;
-    for (const auto& [price, level] : book.asks()) total_volume += level.total_volume;
+        auto trades = engine_.match_limit_order(o);
+        for (const auto& t : trades) {
+            strategy_.on_trade(t);   // Notify strategy
+        }
+        break;
+    }
+    case EventType::CANCEL:
+        engine_.book().cancel_order(evt.id);
+        break;
+    case EventType::MODIFY:
+        engine_.book().modify_order(evt.id, evt.price, evt.qty);
+        break;
+    }
+}
+
+void PaperTradingEngine::feed_events_pipelined(const std::vector<HistoricalEvent>& events,
+                                               std::size_t ring_capacity)
+{
+    PipelinedReplay replay(engine_, ring_capacity);
+    replay.run([&events](auto&& sink) {
+        for (const auto& e : events) sink(e);
+    }, strategy_);
 
-    AnalyticsSnapshot snap{ts, (best_bid + best_ask) / 2, total_volume};
-    analytics_.push_back(snap);
+    trades_.insert(trades_.end(), replay.trades().begin(), replay.trades().end());
+    analytics_.insert(analytics_.end(), replay.analytics().begin(), replay.analytics().end());
 }
 
 } // namespace lob
\ No newline at end of file
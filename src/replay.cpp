@@ -0,0 +1,53 @@
+#include "lob/replay.hpp"
+
+namespace lob {
+
+template<TradeSink B>
+void apply_event(MatchingEngine& engine, const HistoricalEvent& e, B& trades)
+{
+    switch (e.type) {
+    case EventType::LIMIT: {
+        auto* o = engine.book().pool().allocate();
+        if (!o) break;   // pool exhausted
+        o->id = e.order_id;
+        o->side = e.side;
+        o->price = e.price;
+        o->qty = e.qty;
+        o->remaining = e.qty;
+        o->owner = e.participant;
+        o->ts = e.ts;
+
+        engine.match_limit_order(o, trades);
+        break;
+    }
+    case EventType::CANCEL: {
+        engine.book().cancel_order(e.order_id);
+        break;
+    }
+    case EventType::MODIFY: {
+        engine.modify_order(e.order_id, e.price, e.qty, e.ts, trades);
+        break;
+    }
+    }
+}
+
+template void apply_event(MatchingEngine&, const HistoricalEvent&, std::vector<TradeEvent>&);
+template void apply_event(MatchingEngine&, const HistoricalEvent&, TradeBuffer&);
+
+AnalyticsSnapshot make_analytics_snapshot(const OrderBook& book, Timestamp ts)
+{
+    const PriceLevel* bid = book.best_bid();
+    const PriceLevel* ask = book.best_ask();
+
+    // One-sided book: the side that exists is the best estimate
+    Price mid = 0;
+    if (bid && ask) {
+        mid = (bid->price + ask->price) / 2;
+    } else if (bid || ask) {
+        mid = bid ? bid->price : ask->price;
+    }
+
+    return AnalyticsSnapshot{ts, mid, book.total_volume()};
+}
+
+} // namespace lob
@@ -0,0 +1,65 @@
+#include "lob/risk_engine.hpp"
+
+namespace lob {
+
+RiskEngine::RiskEngine(OrderBook& book, std::size_t max_accounts, std::pmr::memory_resource* mr)
+    : book_(book), slots_(max_accounts, mr)
+{}
+
+bool RiskEngine::set_limits(ParticipantId account, const RiskLimits& limits)
+{
+    if (account == 0 || account >= slots_.size()) return false;
+
+    Slot& slot = slots_[account];
+    slot.limits   = limits;
+    slot.exposure = &book_.register_participant(account);   // stable: node-based map
+    slot.active   = true;
+    return true;
+}
+
+const RiskLimits* RiskEngine::limits(ParticipantId account) const noexcept
+{
+    if (account >= slots_.size() || !slots_[account].active) return nullptr;
+    return &slots_[account].limits;
+}
+
+void RiskEngine::kill(ParticipantId account) noexcept
+{
+    if (account >= slots_.size()) return;
+    slots_[account].killed.store(true, std::memory_order_release);
+    kills_pending_.fetch_add(1, std::memory_order_release);
+}
+
+void RiskEngine::revive(ParticipantId account) noexcept
+{
+    if (account >= slots_.size()) return;
+    slots_[account].killed.store(false, std::memory_order_release);
+}
+
+bool RiskEngine::killed(ParticipantId account) const noexcept
+{
+    return account < slots_.size() && slots_[account].killed.load(std::memory_order_acquire);
+}
+
+uint64_t RiskEngine::rejected(ParticipantId account) const noexcept
+{
+    return account < slots_.size() ? slots_[account].rejected : 0;
+}
+
+std::size_t RiskEngine::flatten_killed()
+{
+    // Claim the requests first: a kill() racing with the scan below leaves
+    // the counter non-zero, so the next command scans again
+    kills_pending_.exchange(0, std::memory_order_acquire);
+
+    std::size_t cancelled = 0;
+    for (ParticipantId account = 1; account < slots_.size(); ++account) {
+        const Slot& slot = slots_[account];
+        if (!slot.killed.load(std::memory_order_acquire)) continue;
+        if (slot.exposure && slot.exposure->open_orders == 0) continue;
+        cancelled += book_.cancel_participant(account);
+    }
+    return cancelled;
+}
+
+} // namespace lob
@@ -0,0 +1,153 @@
+#include <catch2/catch_test_macros.hpp>
+#include "lob/matching_engine.hpp"
+
+using namespace lob;
+
+namespace {
+
+void submit(MatchingEngine& engine, OrderId id, Side side, Price price, Quantity qty,
+            std::vector<TradeEvent>& trades)
+{
+    Order* o = engine.book().pool().allocate();
+    o->id = id;
+    o->side = side;
+    o->price = price;
+    o->qty = qty;
+    o->remaining = qty;
+    o->ts = id;
+    engine.match_limit_order(o, trades);
+}
+
+} // namespace
+
+TEST_CASE("Auction mode accumulates without trading", "[auction]") {
+    MatchingEngine engine(64);
+    engine.set_mode(MatchingMode::Auction);
+    std::vector<TradeEvent> trades;
+
+    submit(engine, 1, Side::Buy, 101, 10, trades);
+    submit(engine, 2, Side::Sell, 99, 5, trades);
+
+    REQUIRE(trades.empty());
+    REQUIRE(engine.book().size() == 2);
+
+    auto eq = engine.indicative();
+    REQUIRE(eq.crossed);
+    REQUIRE(eq.volume == 5);
+    REQUIRE(eq.imbalance == 5);
+    // Bid surplus: highest price among the equally good candidates
+    REQUIRE(eq.price == 101);
+
+    // Indicative follows the book as orders arrive
+    submit(engine, 3, Side::Sell, 100, 5, trades);
+    eq = engine.indicative();
+    REQUIRE(eq.volume == 10);
+    REQUIRE(eq.imbalance == 0);
+    REQUIRE(eq.price == 100);
+}
+
+TEST_CASE("Auction rests are timed into perf", "[auction]") {
+    MatchingEngine engine(64);
+    engine.set_mode(MatchingMode::Auction);
+    std::vector<TradeEvent> trades;
+
+    submit(engine, 1, Side::Buy, 101, 10, trades);
+    submit(engine, 2, Side::Sell, 99, 5, trades);
+
+    REQUIRE(engine.perf.latencies_us.size() == 2);
+}
+
+TEST_CASE("Tied equilibrium reports the imbalance at the chosen price", "[auction]") {
+    MatchingEngine engine(64);
+    engine.set_mode(MatchingMode::Auction);
+    std::vector<TradeEvent> trades;
+
+    // 100: 15 bid vs 10 ask; 101: 10 bid vs 15 ask. Same volume and
+    // |imbalance|; the bid surplus at the first candidate picks 101.
+    submit(engine, 1, Side::Buy, 101, 10, trades);
+    submit(engine, 2, Side::Buy, 100, 5, trades);
+    submit(engine, 3, Side::Sell, 100, 10, trades);
+    submit(engine, 4, Side::Sell, 101, 5, trades);
+
+    auto eq = engine.indicative();
+    REQUIRE(eq.crossed);
+    REQUIRE(eq.volume == 10);
+    REQUIRE(eq.price == 101);
+    REQUIRE(eq.imbalance == -5);
+}
+
+TEST_CASE("Equilibrium maximises volume then minimises imbalance", "[auction]") {
+    MatchingEngine engine(64);
+    engine.set_mode(MatchingMode::Auction);
+    std::vector<TradeEvent> trades;
+
+    submit(engine, 1, Side::Buy, 102, 10, trades);
+    submit(engine, 2, Side::Buy, 101, 20, trades);
+    submit(engine, 3, Side::Buy, 100, 30, trades);
+    submit(engine, 4, Side::Sell, 99, 15, trades);
+    submit(engine, 5, Side::Sell, 100, 15, trades);
+    submit(engine, 6, Side::Sell, 101, 25, trades);
+
+    auto eq = engine.indicative();
+    REQUIRE(eq.crossed);
+    REQUIRE(eq.price == 101);
+    REQUIRE(eq.volume == 30);
+    REQUIRE(eq.imbalance == -25);
+
+    auto fills = engine.uncross(1000);
+    Quantity executed = 0;
+    for (const auto& t : fills) {
+        REQUIRE(t.price == 101);
+        REQUIRE(t.ts == 1000);
+        executed += t.quantity;
+    }
+    REQUIRE(executed == 30);
+
+    // Bids 102/101 and asks 99/100 are gone; the rest is no longer crossed
+    REQUIRE(engine.book().size() == 2);
+    REQUIRE(engine.book().bids().size() == 1);
+    REQUIRE(engine.book().bids().begin()->first == 100);
+    REQUIRE(engine.book().bids().begin()->second.total_volume == 30);
+    REQUIRE(engine.book().asks().size() == 1);
+    REQUIRE(engine.book().asks().begin()->first == 101);
+    REQUIRE(engine.book().asks().begin()->second.total_volume == 25);
+    REQUIRE_FALSE(engine.indicative().crossed);
+    REQUIRE(engine.book().total_volume() == 55);
+    REQUIRE(engine.book().pool().active() == 2);
+}
+
+TEST_CASE("Uncross fills in time priority and resumes continuous trading", "[auction]") {
+    MatchingEngine engine(64);
+    engine.set_mode(MatchingMode::Auction);
+    std::vector<TradeEvent> trades;
+
+    submit(engine, 1, Side::Buy, 100, 5, trades);
+    submit(engine, 2, Side::Buy, 100, 5, trades);
+    submit(engine, 3, Side::Sell, 100, 7, trades);
+
+    auto fills = engine.uncross(50);
+    REQUIRE(fills.size() == 2);
+    REQUIRE(fills[0].resting_order_id == 1);
+    REQUIRE(fills[0].quantity == 5);
+    REQUIRE(fills[1].resting_order_id == 2);
+    REQUIRE(fills[1].quantity == 2);
+    REQUIRE(engine.book().order_index().at(2)->remaining == 3);
+
+    engine.set_mode(MatchingMode::Continuous);
+    submit(engine, 4, Side::Sell, 100, 3, trades);
+    REQUIRE(trades.size() == 1);
+    REQUIRE(trades[0].resting_order_id == 2);
+    REQUIRE(engine.book().size() == 0);
+}
+
+TEST_CASE("Uncross on an uncrossed book is a no-op", "[auction]") {
+    MatchingEngine engine(16);
+    engine.set_mode(MatchingMode::Auction);
+    std::vector<TradeEvent> trades;
+
+    REQUIRE_FALSE(engine.indicative().crossed);
+    submit(engine, 1, Side::Buy, 99, 5, trades);
+    submit(engine, 2, Side::Sell, 100, 5, trades);
+    REQUIRE(engine.uncross(1).empty());
+    REQUIRE(engine.book().size() == 2);
+}
@@ -0,0 +1,140 @@
+#include <catch2/catch_test_macros.hpp>
+#include "lob/order_book.hpp"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+void fill_book(OrderBook& book, OrderId count, Side side, Price base, Price levels, ParticipantId owner = 0)
+{
+    for (OrderId i = 0; i < count; ++i) {
+        Price px = side == Side::Buy ? base - static_cast<Price>(i) % levels
+                                     : base + static_cast<Price>(i) % levels;
+        book.add_limit_order_no_match(i + 1 + (side == Side::Sell ? 1'000'000 : 0),
+                                      side, px, 10, i, owner);
+    }
+}
+
+} // namespace
+
+TEST_CASE("Cancel one side", "[bulk]") {
+    OrderBook book(4096);
+    fill_book(book, 500, Side::Buy, 100, 20, 3);
+    fill_book(book, 300, Side::Sell, 101, 10, 3);
+
+    REQUIRE(book.cancel_side(Side::Buy) == 500);
+    REQUIRE(book.bids().empty());
+    REQUIRE(book.size() == 300);
+    REQUIRE(book.total_volume() == 3000);
+    REQUIRE(book.pool().active() == 300);
+    REQUIRE(book.participant(3)->open_orders == 300);
+    REQUIRE(book.participant(3)->open_buy_qty == 0);
+
+    // Whole-book path: the other side is empty now
+    REQUIRE(book.cancel_side(Side::Sell) == 300);
+    REQUIRE(book.size() == 0);
+    REQUIRE(book.total_volume() == 0);
+    REQUIRE(book.pool().active() == 0);
+    REQUIRE(book.participant(3)->head == nullptr);
+
+    REQUIRE(book.cancel_side(Side::Sell) == 0);
+
+    // Freed slots are reusable
+    fill_book(book, 4096, Side::Buy, 100, 50);
+    REQUIRE(book.size() == 4096);
+}
+
+TEST_CASE("Cancel at or beyond a price", "[bulk]") {
+    OrderBook book(1024);
+    fill_book(book, 100, Side::Buy, 100, 10);    // bids 91..100
+    fill_book(book, 100, Side::Sell, 101, 10);   // asks 101..110
+
+    REQUIRE(book.cancel_at_or_beyond(Side::Buy, 95) == 50);   // 91..95
+    REQUIRE(book.bids().size() == 5);
+    REQUIRE(book.best_bid()->price == 100);
+    REQUIRE(book.bids().rbegin()->first == 96);
+
+    REQUIRE(book.cancel_at_or_beyond(Side::Sell, 108) == 30); // 108..110
+    REQUIRE(book.asks().size() == 7);
+    REQUIRE(book.asks().rbegin()->first == 107);
+
+    REQUIRE(book.cancel_at_or_beyond(Side::Sell, 200) == 0);
+    REQUIRE(book.size() == 120);
+    REQUIRE(book.total_volume() == 1200);
+}
+
+TEST_CASE("Cancel by list of ids", "[bulk]") {
+    OrderBook book(64);
+    for (OrderId id = 1; id <= 10; ++id) {
+        book.add_limit_order_no_match(id, Side::Buy, 100, 5, id);
+    }
+
+    std::vector<OrderId> ids = {2, 4, 6, 42, 4};
+    REQUIRE(book.cancel_orders(ids) == 3);
+    REQUIRE(book.size() == 7);
+    REQUIRE(book.best_bid()->total_volume == 35);
+    REQUIRE(book.best_bid()->order_count == 7);
+    REQUIRE(book.pool().active() == 7);
+}
+
+TEST_CASE("Bulk side clear vs cancel_order loop", "[bulk][perf]") {
+    const OrderId N = 100'000;
+
+    // Both sides populated: clearing the bids must not cost the asks
+    OrderBook looped(2 * N);
+    fill_book(looped, N, Side::Buy, 100'000, 1000);
+    fill_book(looped, N, Side::Sell, 100'001, 1000);
+    OrderBook bulk(2 * N);
+    fill_book(bulk, N, Side::Buy, 100'000, 1000);
+    fill_book(bulk, N, Side::Sell, 100'001, 1000);
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (OrderId id = 1; id <= N; ++id) looped.cancel_order(id);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::size_t n = bulk.cancel_side(Side::Buy);
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    REQUIRE(n == N);
+    REQUIRE(looped.size() == N);
+    REQUIRE(bulk.size() == N);
+    REQUIRE(bulk.asks().size() == 1000);
+    REQUIRE(bulk.order_index().count(1'000'001) == 1);
+
+    const double loop_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    const double side_ms = std::chrono::duration<double, std::milli>(t2 - t1).count();
+    std::cout << "cancel_order loop (" << N << "): " << loop_ms << " ms\n";
+    std::cout << "cancel_side       (" << N << "): " << side_ms << " ms ("
+              << loop_ms / side_ms << "x)\n";
+}
+
+TEST_CASE("Grouped id-list cancel vs cancel_order loop", "[bulk][perf]") {
+    const OrderId N = 100'000;
+
+    OrderBook looped(N);
+    fill_book(looped, N, Side::Buy, 100'000, 1000);
+    OrderBook bulk(N);
+    fill_book(bulk, N, Side::Buy, 100'000, 1000);
+
+    // Every other order: levels survive, so each one is settled, not dropped
+    std::vector<OrderId> ids;
+    for (OrderId id = 1; id <= N; id += 2) ids.push_back(id);
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (OrderId id : ids) looped.cancel_order(id);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::size_t n = bulk.cancel_orders(ids);
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    REQUIRE(n == ids.size());
+    REQUIRE(bulk.size() == looped.size());
+    REQUIRE(bulk.total_volume() == looped.total_volume());
+    REQUIRE(bulk.bids().size() == looped.bids().size());
+
+    std::cout << "cancel_order loop (" << ids.size() << "): "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms\n";
+    std::cout << "cancel_orders     (" << ids.size() << "): "
+              << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms\n";
+}
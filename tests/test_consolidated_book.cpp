@@ -0,0 +1,183 @@
+#include <catch2/catch_test_macros.hpp>
+#include "lob/consolidated_book.hpp"
+#include "lob/matching_engine.hpp"
+#include <array>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+// Reference: scan every venue
+std::optional<VenueLevel> scan_best(const std::vector<OrderBook*>& venues, Side side)
+{
+    std::optional<VenueLevel> best;
+    for (VenueId v = 0; v < venues.size(); ++v) {
+        const PriceLevel* top = side == Side::Buy ? venues[v]->best_bid() : venues[v]->best_ask();
+        if (!top) continue;
+        const bool better = !best || (side == Side::Buy ? top->price > best->price : top->price < best->price);
+        if (better) best = VenueLevel{top->price, top->total_volume, v};
+    }
+    return best;
+}
+
+} // namespace
+
+TEST_CASE("NBBO follows every venue's top of book", "[consolidated]") {
+    OrderBook a(64), b(64), c(64);
+    a.add_limit_order_no_match(1, Side::Buy, 100, 10, 1);
+    std::vector<OrderBook*> venues = {&a, &b, &c};
+    ConsolidatedBook sip(venues);
+
+    // Seeded from existing state
+    auto nbbo = sip.nbbo();
+    REQUIRE(nbbo.bid);
+    REQUIRE(nbbo.bid->venue == 0);
+    REQUIRE_FALSE(nbbo.ask);
+
+    b.add_limit_order_no_match(2, Side::Buy, 101, 5, 2);
+    c.add_limit_order_no_match(3, Side::Sell, 103, 7, 3);
+    a.add_limit_order_no_match(4, Side::Sell, 104, 9, 4);
+
+    nbbo = sip.nbbo();
+    REQUIRE(nbbo.bid->price == 101);
+    REQUIRE(nbbo.bid->venue == 1);
+    REQUIRE(nbbo.ask->price == 103);
+    REQUIRE(nbbo.ask->volume == 7);
+    REQUIRE(nbbo.ask->venue == 2);
+
+    // Size change at the touch is a top-of-book change too
+    c.add_limit_order_no_match(5, Side::Sell, 103, 3, 5);
+    REQUIRE(sip.best(Side::Sell)->volume == 10);
+    c.modify_order(3, 103, 2);
+    REQUIRE(sip.best(Side::Sell)->volume == 5);
+
+    // Ties go to the lower venue
+    a.add_limit_order_no_match(6, Side::Buy, 101, 1, 6);
+    REQUIRE(sip.best(Side::Buy)->venue == 0);
+
+    // Cancels and bulk cancels fall back to the next venue
+    a.cancel_side(Side::Buy);
+    REQUIRE(sip.best(Side::Buy)->venue == 1);
+    b.cancel_order(2);
+    REQUIRE_FALSE(sip.best(Side::Buy));
+    c.cancel_at_or_beyond(Side::Sell, 0);
+    REQUIRE(sip.best(Side::Sell)->venue == 0);
+    REQUIRE(sip.best(Side::Sell)->price == 104);
+}
+
+TEST_CASE("Top-N depth merges venues with attribution", "[consolidated]") {
+    OrderBook a(64), b(64);
+    a.add_limit_order_no_match(1, Side::Sell, 101, 10, 1);
+    a.add_limit_order_no_match(2, Side::Sell, 103, 10, 2);
+    b.add_limit_order_no_match(3, Side::Sell, 101, 4, 3);
+    b.add_limit_order_no_match(4, Side::Sell, 102, 6, 4);
+    b.add_limit_order_no_match(5, Side::Sell, 105, 6, 5);
+    a.add_limit_order_no_match(6, Side::Buy, 99, 1, 6);
+    b.add_limit_order_no_match(7, Side::Buy, 100, 2, 7);
+
+    std::vector<OrderBook*> venues = {&a, &b};
+    ConsolidatedBook sip(venues);
+
+    std::array<VenueLevel, 4> ladder{};
+    REQUIRE(sip.depth(Side::Sell, ladder) == 4);
+    REQUIRE(ladder[0].price == 101);
+    REQUIRE(ladder[0].venue == 0);
+    REQUIRE(ladder[1].price == 101);
+    REQUIRE(ladder[1].venue == 1);
+    REQUIRE(ladder[1].volume == 4);
+    REQUIRE(ladder[2].price == 102);
+    REQUIRE(ladder[3].price == 103);
+
+    std::array<VenueLevel, 8> bids{};
+    REQUIRE(sip.depth(Side::Buy, bids) == 2);
+    REQUIRE(bids[0].price == 100);
+    REQUIRE(bids[0].venue == 1);
+    REQUIRE(bids[1].price == 99);
+}
+
+TEST_CASE("Consolidated view matches a full scan under matching", "[consolidated]") {
+    constexpr std::size_t kVenues = 5;
+    std::vector<std::unique_ptr<MatchingEngine>> engines;
+    std::vector<OrderBook*> venues;
+    for (std::size_t i = 0; i < kVenues; ++i) {
+        engines.push_back(std::make_unique<MatchingEngine>(4096));
+        venues.push_back(&engines.back()->book());
+    }
+    ConsolidatedBook sip(venues);
+
+    std::mt19937_64 rng(11);
+    TradeBuffer trades;
+    for (OrderId id = 1; id <= 20000; ++id) {
+        MatchingEngine& engine = *engines[rng() % kVenues];
+        if (rng() % 4 == 0 && engine.book().size() > 0) {
+            engine.book().cancel_order(engine.book().order_index().begin()->first);
+        } else {
+            Order* o = engine.book().pool().allocate();
+            if (!o) continue;
+            o->id        = id;
+            o->side      = (rng() & 1) ? Side::Buy : Side::Sell;
+            o->price     = (o->side == Side::Buy ? 998 : 1002) + static_cast<Price>(rng() % 9) - 4;
+            o->qty       = 1 + static_cast<Quantity>(rng() % 20);
+            o->remaining = o->qty;
+            o->ts        = id;
+            engine.match_limit_order(o, trades);
+        }
+
+        for (Side side : {Side::Buy, Side::Sell}) {
+            auto expect = scan_best(venues, side);
+            auto got = sip.best(side);
+            REQUIRE(expect.has_value() == got.has_value());
+            if (expect) {
+                REQUIRE(got->price == expect->price);
+                REQUIRE(got->volume == expect->volume);
+                REQUIRE(got->venue == expect->venue);
+            }
+        }
+    }
+    REQUIRE_FALSE(trades.empty());
+}
+
+TEST_CASE("Depth over more venues than requested levels", "[consolidated]") {
+    std::vector<std::unique_ptr<OrderBook>> books;
+    std::vector<OrderBook*> venues;
+    for (VenueId v = 0; v < 6; ++v) {
+        books.push_back(std::make_unique<OrderBook>(64));
+        venues.push_back(books.back().get());
+    }
+    // Venue v asks at 110 - v; venue 5 also at 101, venue 2 at 100
+    for (VenueId v = 0; v < 6; ++v) {
+        venues[v]->add_limit_order_no_match(2 * v + 1, Side::Sell, static_cast<Price>(110 - v), 1, 1);
+    }
+    venues[5]->add_limit_order_no_match(20, Side::Sell, 101, 1, 2);
+    venues[2]->add_limit_order_no_match(21, Side::Sell, 100, 1, 3);
+
+    ConsolidatedBook sip(venues);
+    std::array<VenueLevel, 3> ladder{};
+    REQUIRE(sip.depth(Side::Sell, ladder) == 3);
+    REQUIRE(ladder[0].price == 100);
+    REQUIRE(ladder[0].venue == 2);
+    REQUIRE(ladder[1].price == 101);
+    REQUIRE(ladder[1].venue == 5);
+    REQUIRE(ladder[2].price == 105);
+    REQUIRE(ladder[2].venue == 5);
+}
+
+TEST_CASE("An existing top-of-book listener is chained and restored", "[consolidated]") {
+    OrderBook a(64);
+    std::size_t calls = 0;
+    a.set_top_of_book_listener([&](Side) { ++calls; });
+
+    {
+        std::vector<OrderBook*> venues = {&a};
+        ConsolidatedBook sip(venues);
+        a.add_limit_order_no_match(1, Side::Buy, 100, 10, 1);
+        REQUIRE(calls == 1);
+        REQUIRE(sip.best(Side::Buy)->price == 100);
+    }
+
+    a.add_limit_order_no_match(2, Side::Buy, 101, 10, 2);
+    REQUIRE(calls == 2);
+}
@@ -0,0 +1,135 @@
+#include <catch2/catch_test_macros.hpp>
+#include "lob/matching_engine.hpp"
+#include "lob/depth_index.hpp"
+#include <random>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+// Reference answers from a level-by-level walk, best price first
+SweepCost walk_cost(const OrderBook& book, Side side, Quantity qty)
+{
+    SweepCost cost{};
+    auto take = [&](Price price, Quantity volume) {
+        if (cost.filled >= qty) return;
+        Quantity q = std::min(volume, qty - cost.filled);
+        cost.filled      += q;
+        cost.notional    += q * price;
+        cost.worst_price  = price;
+    };
+    if (side == Side::Buy) {
+        for (const auto& [price, level] : book.bids()) take(price, level.total_volume);
+    } else {
+        for (const auto& [price, level] : book.asks()) take(price, level.total_volume);
+    }
+    return cost;
+}
+
+Quantity walk_volume(const OrderBook& book, Side side, Price price)
+{
+    Quantity sum = 0;
+    if (side == Side::Buy) {
+        for (auto it = book.bids().begin(); it != book.bids().end() && it->first >= price; ++it) sum += it->second.total_volume;
+    } else {
+        for (auto it = book.asks().begin(); it != book.asks().end() && it->first <= price; ++it) sum += it->second.total_volume;
+    }
+    return sum;
+}
+
+} // namespace
+
+TEST_CASE("Depth queries on a static book", "[depth]") {
+    OrderBook book(64);
+    book.add_limit_order_no_match(1, Side::Sell, 101, 10, 1);
+    book.add_limit_order_no_match(2, Side::Sell, 102, 20, 2);
+    book.add_limit_order_no_match(3, Side::Sell, 104, 30, 3);
+    book.add_limit_order_no_match(4, Side::Buy, 100, 5, 4);
+    book.add_limit_order_no_match(5, Side::Buy, 98, 15, 5);
+
+    // Seeded from the existing levels
+    book.enable_depth_index(90, 110);
+    const DepthIndex& depth = *book.depth_index();
+
+    REQUIRE(depth.price_to_volume(Side::Sell, 102) == 30);
+    REQUIRE(depth.price_to_volume(Side::Sell, 103) == 30);
+    REQUIRE(depth.price_to_volume(Side::Buy, 99) == 5);
+    REQUIRE(depth.total_volume(Side::Buy) == 20);
+
+    REQUIRE(depth.volume_to_price(Side::Sell, 10) == 101);
+    REQUIRE(depth.volume_to_price(Side::Sell, 11) == 102);
+    REQUIRE(depth.volume_to_price(Side::Sell, 60) == 104);
+    REQUIRE_FALSE(depth.volume_to_price(Side::Sell, 61));
+    REQUIRE(depth.volume_to_price(Side::Buy, 6) == 98);
+
+    // Buying 25: 10 @ 101 + 15 @ 102
+    auto cost = depth.vwap_for_quantity(Side::Sell, 25);
+    REQUIRE(cost.filled == 25);
+    REQUIRE(cost.notional == 10 * 101 + 15 * 102);
+    REQUIRE(cost.worst_price == 102);
+
+    // More than the book holds: partial, down to the deepest bid
+    cost = depth.vwap_for_quantity(Side::Buy, 100);
+    REQUIRE(cost.filled == 20);
+    REQUIRE(cost.notional == 5 * 100 + 15 * 98);
+    REQUIRE(cost.worst_price == 98);
+
+    // Fills, in-place modifies and cancels all flow into the index
+    book.modify_order(2, 102, 5);
+    book.cancel_order(1);
+    REQUIRE(depth.volume_to_price(Side::Sell, 6) == 104);
+    book.cancel_side(Side::Sell);
+    REQUIRE(depth.total_volume(Side::Sell) == 0);
+    REQUIRE(depth.total_volume(Side::Buy) == 20);
+}
+
+TEST_CASE("Depth index matches a level walk under random flow", "[depth]") {
+    MatchingEngine engine(1 << 14);
+    OrderBook& book = engine.book();
+    book.enable_depth_index(900, 1100);
+
+    std::mt19937_64 rng(7);
+    std::vector<TradeEvent> trades;
+    std::vector<OrderId> ids;
+
+    for (OrderId id = 1; id <= 20000; ++id) {
+        const auto roll = rng() % 10;
+        if (roll < 6 || ids.empty()) {
+            Order* o = book.pool().allocate();
+            o->id        = id;
+            o->side      = (rng() & 1) ? Side::Buy : Side::Sell;
+            o->price     = (o->side == Side::Buy ? 995 : 1005) + static_cast<Price>(rng() % 21) - 10;
+            o->qty       = 1 + static_cast<Quantity>(rng() % 50);
+            o->remaining = o->qty;
+            o->ts        = id;
+            engine.match_limit_order(o, trades);
+            ids.push_back(id);
+        } else if (roll < 8) {
+            book.cancel_order(ids[rng() % ids.size()]);
+        } else {
+            std::vector<TradeEvent> fills;
+            OrderId target = ids[rng() % ids.size()];
+            auto it = book.order_index().find(target);
+            if (it != book.order_index().end()) {
+                engine.modify_order(target, it->second->price, it->second->remaining / 2 + 1, id, fills);
+            }
+        }
+
+        if (id % 97 == 0) {
+            const DepthIndex& depth = *book.depth_index();
+            for (Side side : {Side::Buy, Side::Sell}) {
+                for (Quantity q : {1, 50, 400, 5000}) {
+                    auto expect = walk_cost(book, side, q);
+                    auto got = depth.vwap_for_quantity(side, q);
+                    REQUIRE(got.filled == expect.filled);
+                    REQUIRE(got.notional == expect.notional);
+                    REQUIRE(got.worst_price == expect.worst_price);
+                }
+                for (Price p : {985, 1000, 1015}) {
+                    REQUIRE(depth.price_to_volume(side, p) == walk_volume(book, side, p));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#include <catch2/catch_test_macros.hpp>
+#include "lob/feature_engine.hpp"
+#include "lob/flow_generator.hpp"
+#include "lob/strategy_engine.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+HistoricalEvent limit(OrderId id, Side side, Price price, Quantity qty, Timestamp ts)
+{
+    return HistoricalEvent{id, EventType::LIMIT, id, side, price, qty, ts};
+}
+
+HistoricalEvent cancel(OrderId id, Timestamp ts)
+{
+    return HistoricalEvent{id + 1000, EventType::CANCEL, id, Side::Buy, 0, 0, ts};
+}
+
+} // namespace
+
+TEST_CASE("Analytics mid uses the remaining side of a one-sided book", "[features]") {
+    OrderBook book(16);
+    REQUIRE(make_analytics_snapshot(book, 1).mid_price == 0);
+    book.add_limit_order_no_match(1, Side::Buy, 100, 5, 1);
+    REQUIRE(make_analytics_snapshot(book, 2).mid_price == 100);
+    book.add_limit_order_no_match(2, Side::Sell, 104, 5, 2);
+    REQUIRE(make_analytics_snapshot(book, 3).mid_price == 102);
+    book.cancel_order(1);
+    REQUIRE(make_analytics_snapshot(book, 4).mid_price == 104);
+}
+
+TEST_CASE("Book features per event", "[features]") {
+    StrategyEngine<FeatureEngine<2>> replay(64);
+
+    std::vector<HistoricalEvent> events = {
+        limit(1, Side::Buy, 100, 30, 10),     // one-sided
+        limit(2, Side::Sell, 102, 10, 20),
+        limit(3, Side::Buy, 99, 20, 30),
+        limit(4, Side::Sell, 103, 40, 40),
+        limit(5, Side::Buy, 100, 10, 50),     // join the bid: OFI +10
+        cancel(2, 60),                        // ask touch leaves: OFI +10
+    };
+    replay.feed_events(events);
+
+    const auto& f = replay.strategy().features();
+    REQUIRE(f.size() == 6);
+
+    REQUIRE(f.mid[0] == 100.0);
+    REQUIRE(f.spread[0] == 0.0);
+    REQUIRE(f.imbalance[0] == 1.0);
+
+    // Touch 100 x 30 / 102 x 10
+    REQUIRE(f.mid[1] == 101.0);
+    REQUIRE(f.spread[1] == 2.0);
+    REQUIRE(std::abs(f.microprice[1] - (102.0 * 30 + 100.0 * 10) / 40) < 1e-12);
+
+    // Top 2: bids 30 + 20, asks 10 + 40
+    REQUIRE(f.imbalance[3] == 0.0);
+
+    REQUIRE(f.ofi[4] == 10.0);
+    REQUIRE(f.ofi[5] == 10.0);
+    REQUIRE(f.mid[5] == 101.5);
+
+    const auto& bids = replay.strategy().bids();
+    REQUIRE(bids.depth == 2);
+    REQUIRE(bids.price[0] == 100);
+    REQUIRE(bids.qty[0] == 40);
+    REQUIRE(bids.price[1] == 99);
+}
+
+TEST_CASE("Rolling VWAP and trade intensity", "[features]") {
+    FeatureConfig cfg;
+    cfg.window_ns = 100;
+    StrategyEngine<FeatureEngine<1>> replay(64, cfg);
+
+    std::vector<HistoricalEvent> events = {
+        limit(1, Side::Sell, 100, 10, 0),
+        limit(2, Side::Sell, 110, 10, 0),
+        limit(3, Side::Buy, 100, 5, 10),      // 5 @ 100
+        limit(4, Side::Buy, 110, 10, 50),     // 5 @ 100, 5 @ 110
+        limit(5, Side::Buy, 90, 1, 120),      // first trade (t=10) left the window
+        limit(6, Side::Buy, 90, 1, 500),      // window empty
+    };
+    replay.feed_events(events);
+
+    const auto& f = replay.strategy().features();
+    REQUIRE(f.vwap[2] == 100.0);
+    REQUIRE(std::abs(f.vwap[3] - (5 * 100.0 + 5 * 100.0 + 5 * 110.0) / 15) < 1e-9);
+    REQUIRE(std::abs(f.trade_intensity[3] - 3e7) < 1e-3);
+    REQUIRE(std::abs(f.vwap[4] - (5 * 100.0 + 5 * 110.0) / 10) < 1e-9);
+    REQUIRE(std::abs(f.trade_intensity[4] - 2e7) < 1e-3);
+    REQUIRE(f.vwap[5] == 0.0);
+    REQUIRE(f.trade_intensity[5] == 0.0);
+}
+
+TEST_CASE("A zero trade window is rejected", "[features]") {
+    FeatureConfig cfg;
+    cfg.window_ns = 0;
+    REQUIRE_THROWS_AS(FeatureEngine<1>(cfg), std::invalid_argument);
+}
+
+TEST_CASE("Columns stay aligned under generated flow", "[features]") {
+    FlowConfig cfg;
+    cfg.seed = 9;
+    FlowGenerator flow(cfg);
+    std::vector<HistoricalEvent> events(50000);
+    flow.generate(events);
+
+    StrategyEngine<FeatureEngine<10>> replay(1 << 16);
+    replay.strategy().features().reserve(events.size());
+    replay.feed_events(events);
+
+    const auto& f = replay.strategy().features();
+    REQUIRE(f.size() == events.size());
+    REQUIRE(f.ofi.size() == f.size());
+    REQUIRE(f.trade_intensity.size() == f.size());
+    for (std::size_t i = 0; i < f.size(); ++i) {
+        REQUIRE(f.imbalance[i] >= -1.0);
+        REQUIRE(f.imbalance[i] <= 1.0);
+        REQUIRE(f.spread[i] >= 0.0);
+        if (f.spread[i] > 0) {
+            REQUIRE(f.microprice[i] >= f.mid[i] - f.spread[i] / 2);
+            REQUIRE(f.microprice[i] <= f.mid[i] + f.spread[i] / 2);
+        }
+    }
+}
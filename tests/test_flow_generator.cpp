@@ -0,0 +1,209 @@
+#include <catch2/catch_test_macros.hpp>
+#include "lob/flow_generator.hpp"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+// Variance / mean of event counts per fixed window (1 for Poisson)
+double dispersion(const std::vector<HistoricalEvent>& events, Timestamp window)
+{
+    std::vector<double> counts;
+    Timestamp edge = events.front().ts + window;
+    double n = 0;
+    for (const auto& e : events) {
+        if (e.type != EventType::LIMIT) continue;
+        while (e.ts >= edge) {
+            counts.push_back(n);
+            n = 0;
+            edge += window;
+        }
+        ++n;
+    }
+    double mean = 0;
+    for (double c : counts) mean += c;
+    mean /= static_cast<double>(counts.size());
+    double var = 0;
+    for (double c : counts) var += (c - mean) * (c - mean);
+    var /= static_cast<double>(counts.size());
+    return var / mean;
+}
+
+} // namespace
+
+TEST_CASE("Flow is deterministic per seed", "[flow]") {
+    FlowConfig cfg;
+    cfg.seed = 7;
+    FlowGenerator a(cfg), b(cfg);
+    cfg.seed = 8;
+    FlowGenerator c(cfg);
+
+    bool differs = false;
+    for (int i = 0; i < 10000; ++i) {
+        auto x = a.next();
+        auto y = b.next();
+        auto z = c.next();
+        REQUIRE(x.id == y.id);
+        REQUIRE(x.type == y.type);
+        REQUIRE(x.order_id == y.order_id);
+        REQUIRE(x.price == y.price);
+        REQUIRE(x.qty == y.qty);
+        REQUIRE(x.ts == y.ts);
+        differs |= (x.price != z.price || x.ts != z.ts);
+    }
+    REQUIRE(differs);
+}
+
+TEST_CASE("Flow has the configured structure", "[flow]") {
+    FlowConfig cfg;
+    cfg.seed = 3;
+    cfg.cancel_ratio = 0.7;
+    cfg.modify_ratio = 0.25;
+    cfg.min_qty = 5;
+    cfg.max_qty = 10;
+    cfg.participants = 4;
+    FlowGenerator flow(cfg);
+
+    std::vector<HistoricalEvent> events(400000);
+    flow.generate(events);
+
+    std::size_t limits = 0, cancels = 0, modifies = 0;
+    Timestamp last = 0;
+    for (const auto& e : events) {
+        REQUIRE(e.ts >= last);
+        last = e.ts;
+        switch (e.type) {
+        case EventType::LIMIT:
+            ++limits;
+            REQUIRE(e.qty >= 5);
+            REQUIRE(e.qty <= 10);
+            REQUIRE(e.participant >= 1);
+            REQUIRE(e.participant <= 4);
+            REQUIRE(std::llabs(e.price - flow.mid()) < 1000);
+            break;
+        case EventType::CANCEL: ++cancels; break;
+        case EventType::MODIFY: ++modifies; break;
+        }
+    }
+
+    // Ratios per new order; the tail of the stream has timers still pending
+    const double c = static_cast<double>(cancels) / static_cast<double>(limits);
+    const double m = static_cast<double>(modifies) / static_cast<double>(limits);
+    REQUIRE(c > 0.6);
+    REQUIRE(c < 0.72);
+    REQUIRE(m > 0.2);
+    REQUIRE(m < 0.27);
+}
+
+TEST_CASE("Lifetimes and Poisson gaps are exponential", "[flow]") {
+    FlowConfig cfg;
+    cfg.seed = 9;
+    cfg.cancel_ratio = 1.0;
+    cfg.modify_ratio = 0.0;
+    cfg.mean_lifetime_ns = 1e6;
+    FlowGenerator flow(cfg);
+
+    std::vector<HistoricalEvent> events(1'000'000);
+    flow.generate(events);
+
+    // Exponential: mean == standard deviation
+    std::vector<Timestamp> placed(events.size() + 1, 0);
+    double life = 0, life2 = 0, n = 0;
+    double gap = 0, gap2 = 0, gaps = 0;
+    const HistoricalEvent* prev = nullptr;
+    for (const auto& e : events) {
+        if (e.type == EventType::LIMIT) {
+            placed[e.order_id] = e.ts;
+            if (prev) {
+                const double g = static_cast<double>(e.ts - prev->ts);
+                gap += g; gap2 += g * g; ++gaps;
+            }
+            prev = &e;
+        } else {
+            const double l = static_cast<double>(e.ts - placed[e.order_id] - 1);
+            life += l; life2 += l * l; ++n;
+        }
+    }
+    const double life_mean = life / n, gap_mean = gap / gaps;
+    const double life_sd = std::sqrt(life2 / n - life_mean * life_mean);
+    const double gap_sd  = std::sqrt(gap2 / gaps - gap_mean * gap_mean);
+
+    REQUIRE(std::abs(life_mean / 1e6 - 1.0) < 0.02);
+    REQUIRE(std::abs(life_sd / life_mean - 1.0) < 0.02);
+    REQUIRE(std::abs(gap_mean / 1e3 - 1.0) < 0.02);   // base_rate 1e6/s
+    REQUIRE(std::abs(gap_sd / gap_mean - 1.0) < 0.02);
+}
+
+TEST_CASE("Hawkes arrivals cluster, Poisson arrivals do not", "[flow]") {
+    FlowConfig cfg;
+    cfg.seed = 5;
+    cfg.cancel_ratio = 0;
+    cfg.modify_ratio = 0;
+    cfg.base_rate = 1e6;
+
+    std::vector<HistoricalEvent> events(200000);
+    FlowGenerator poisson(cfg);
+    poisson.generate(events);
+    const double flat = dispersion(events, 20'000);
+
+    cfg.excitation = 0.8e5;   // branching ratio 0.8
+    cfg.decay = 1e5;
+    FlowGenerator hawkes(cfg);
+    hawkes.generate(events);
+    const double clustered = dispersion(events, 20'000);
+
+    std::cout << "Count dispersion: poisson " << flat << ", hawkes " << clustered << "\n";
+    REQUIRE(flat > 0.8);
+    REQUIRE(flat < 1.2);
+    REQUIRE(clustered > 3.0);
+}
+
+TEST_CASE("Soak: generated flow keeps the engine consistent", "[flow][soak]") {
+    FlowConfig cfg;
+    cfg.seed = 11;
+    cfg.excitation = 0.5e6;
+    cfg.decay = 1e6;
+    cfg.marketable_ratio = 0.15;
+    cfg.participants = 16;
+    FlowGenerator flow(cfg);
+
+    MatchingEngine engine(1 << 18);
+    engine.perf.reserve(1 << 21);
+    TradeBuffer trades;
+    std::vector<HistoricalEvent> batch(4096);
+
+    constexpr std::size_t kBatches = 250;   // ~1M events
+    std::size_t traded = 0;
+    double gen_seconds = 0;
+
+    for (std::size_t i = 0; i < kBatches; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        flow.generate(batch);
+        gen_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        for (const auto& e : batch) apply_event(engine, e, trades);
+        traded += trades.size();
+        trades.clear();
+    }
+
+    const OrderBook& book = engine.book();
+    Quantity level_volume = 0;
+    std::size_t level_orders = 0;
+    for (const auto& [price, level] : book.bids()) { level_volume += level.total_volume; level_orders += level.order_count; }
+    for (const auto& [price, level] : book.asks()) { level_volume += level.total_volume; level_orders += level.order_count; }
+
+    REQUIRE(traded > 0);
+    REQUIRE(level_volume == book.total_volume());
+    REQUIRE(level_orders == book.size());
+    REQUIRE(book.pool().active() == book.size());
+    REQUIRE((book.bids().empty() || book.asks().empty()
+             || book.bids().begin()->first < book.asks().begin()->first));
+
+    std::cout << "Generated " << kBatches * batch.size() << " events at "
+              << static_cast<double>(kBatches * batch.size()) / gen_seconds / 1e6 << " M/s, "
+              << traded << " trades, " << book.size() << " resting\n";
+}
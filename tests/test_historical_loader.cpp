@@ -0,0 +1,214 @@
+#include <catch2/catch_test_macros.hpp>
+#include "lob/historical_loader.hpp"
+#include "lob/paper_trader.hpp"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+// Append one length-prefixed ITCH message built from raw big-endian fields
+struct ItchWriter {
+    std::string buf;
+    std::string msg;
+
+    ItchWriter& begin(char type, uint16_t locate, uint64_t ts) {
+        msg.clear();
+        msg.push_back(type);
+        be(locate, 2);
+        be(0, 2);          // tracking number
+        be(ts, 6);
+        return *this;
+    }
+    ItchWriter& be(uint64_t v, int bytes) {
+        for (int i = bytes - 1; i >= 0; --i) msg.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+        return *this;
+    }
+    ItchWriter& raw(const char* s, std::size_t n) { msg.append(s, n); return *this; }
+    void end() {
+        buf.push_back(static_cast<char>((msg.size() >> 8) & 0xFF));
+        buf.push_back(static_cast<char>(msg.size() & 0xFF));
+        buf += msg;
+    }
+
+    void add(uint64_t ts, uint64_t ref, char side, uint32_t shares, uint32_t price, uint16_t locate = 1) {
+        begin('A', locate, ts).be(ref, 8).raw(&side, 1).be(shares, 4).raw("AAPL    ", 8).be(price, 4).end();
+    }
+    void execute(uint64_t ts, uint64_t ref, uint32_t shares) {
+        begin('E', 1, ts).be(ref, 8).be(shares, 4).be(42, 8).end();
+    }
+    void cancel(uint64_t ts, uint64_t ref, uint32_t shares) {
+        begin('X', 1, ts).be(ref, 8).be(shares, 4).end();
+    }
+    void remove(uint64_t ts, uint64_t ref) {
+        begin('D', 1, ts).be(ref, 8).end();
+    }
+    void replace(uint64_t ts, uint64_t old_ref, uint64_t new_ref, uint32_t shares, uint32_t price) {
+        begin('U', 1, ts).be(old_ref, 8).be(new_ref, 8).be(shares, 4).be(price, 4).end();
+    }
+};
+
+} // namespace
+
+TEST_CASE("CSV decoder parses rows and skips header", "[loader]") {
+    std::string csv =
+        "id,type,order_id,side,price,qty,ts\r\n"
+        "1,LIMIT,10,B,100,5,1000\r\n"
+        "2,L,11,SELL,101,7,1001\n"
+        "3,MODIFY,10,B,100,3,1002\n"
+        "bogus,line\n"
+        "4,CANCEL,11,S,0,0,1003";
+
+    std::vector<HistoricalEvent> out;
+    auto stats = for_each_csv_event(csv, [&](const HistoricalEvent& e) { out.push_back(e); });
+
+    REQUIRE(stats.events == 4);
+    REQUIRE(stats.skipped == 1);
+    REQUIRE(out.size() == 4);
+
+    REQUIRE(out[0].type == EventType::LIMIT);
+    REQUIRE(out[0].order_id == 10);
+    REQUIRE(out[0].side == Side::Buy);
+    REQUIRE(out[0].price == 100);
+    REQUIRE(out[0].qty == 5);
+    REQUIRE(out[0].ts == 1000);
+
+    REQUIRE(out[1].side == Side::Sell);
+    REQUIRE(out[2].type == EventType::MODIFY);
+    REQUIRE(out[3].type == EventType::CANCEL);
+    REQUIRE(out[3].ts == 1003);   // last line without trailing newline
+}
+
+TEST_CASE("CSV decoder handles fields longer than one SIMD block", "[loader]") {
+    std::string csv = "123456789012345,LIMIT,987654321098765,B,-2500000000,4000000000,18446744073709551615\n";
+
+    std::vector<HistoricalEvent> out;
+    auto stats = for_each_csv_event(csv, [&](const HistoricalEvent& e) { out.push_back(e); });
+
+    REQUIRE(stats.events == 1);
+    REQUIRE(out[0].id == 123456789012345ULL);
+    REQUIRE(out[0].order_id == 987654321098765ULL);
+    REQUIRE(out[0].price == -2500000000LL);
+    REQUIRE(out[0].qty == 4000000000LL);
+    REQUIRE(out[0].ts == 18446744073709551615ULL);
+}
+
+TEST_CASE("CSV decoder reads an optional participant column", "[loader]") {
+    std::string csv =
+        "1,LIMIT,10,B,100,5,1000,7\n"
+        "2,LIMIT,11,S,101,5,1001,\n"
+        "3,LIMIT,12,S,101,5,1002\n"
+        "4,LIMIT,13,S,101,5,1003,x\n"
+        "5,LIMIT,14,S,101,5,1004,7,9\n"
+        "6,CANCEL,10,B,0,0,1005,7";
+
+    std::vector<HistoricalEvent> out;
+    auto stats = for_each_csv_event(csv, [&](const HistoricalEvent& e) { out.push_back(e); });
+
+    REQUIRE(stats.events == 4);
+    REQUIRE(stats.skipped == 2);   // bad owner, too many columns
+    REQUIRE(out[0].participant == 7);
+    REQUIRE(out[1].participant == 0);
+    REQUIRE(out[2].participant == 0);
+    REQUIRE(out[3].participant == 7);
+    REQUIRE(out[3].ts == 1005);
+}
+
+TEST_CASE("ITCH decoder maps order messages onto event types", "[loader]") {
+    ItchWriter w;
+    w.add(1, 100, 'B', 300, 1'000'000);
+    w.add(2, 101, 'S', 200, 1'010'000);
+    w.add(3, 900, 'S', 50, 1'020'000, /*locate=*/7);   // other instrument
+    w.execute(4, 100, 100);
+    w.cancel(5, 101, 200);
+    w.replace(6, 100, 102, 150, 1'005'000);
+    w.remove(7, 102);
+
+    std::vector<HistoricalEvent> out;
+    auto stats = for_each_itch_event(w.buf, [&](const HistoricalEvent& e) { out.push_back(e); }, 1);
+
+    REQUIRE(stats.skipped == 0);
+    REQUIRE(out.size() == 7);
+
+    REQUIRE(out[0].type == EventType::LIMIT);
+    REQUIRE(out[0].order_id == 100);
+    REQUIRE(out[0].side == Side::Buy);
+    REQUIRE(out[0].price == 1'000'000);
+    REQUIRE(out[0].qty == 300);
+    REQUIRE(out[0].ts == 1);
+
+    REQUIRE(out[1].side == Side::Sell);
+
+    // Partial execution -> size-down
+    REQUIRE(out[2].type == EventType::MODIFY);
+    REQUIRE(out[2].order_id == 100);
+    REQUIRE(out[2].qty == 200);
+    REQUIRE(out[2].price == 1'000'000);
+
+    // Full cancel -> CANCEL
+    REQUIRE(out[3].type == EventType::CANCEL);
+    REQUIRE(out[3].order_id == 101);
+
+    // Replace -> CANCEL old + LIMIT new, side carried over
+    REQUIRE(out[4].type == EventType::CANCEL);
+    REQUIRE(out[4].order_id == 100);
+    REQUIRE(out[5].type == EventType::LIMIT);
+    REQUIRE(out[5].order_id == 102);
+    REQUIRE(out[5].side == Side::Buy);
+    REQUIRE(out[5].price == 1'005'000);
+    REQUIRE(out[5].qty == 150);
+
+    REQUIRE(out[6].type == EventType::CANCEL);
+    REQUIRE(out[6].order_id == 102);
+
+    // Event ids are assigned in stream order
+    for (std::size_t i = 1; i < out.size(); ++i) REQUIRE(out[i].id == out[i - 1].id + 1);
+}
+
+TEST_CASE("ITCH decoder reuses live-order nodes once warm", "[loader]") {
+    auto session = [](uint64_t first_ref) {
+        ItchWriter w;
+        for (uint64_t i = 0; i < 1000; ++i) w.add(i, first_ref + i, 'B', 100, 1'000'000);
+        for (uint64_t i = 0; i < 1000; ++i) w.remove(1000 + i, first_ref + i);
+        return w.buf;
+    };
+
+    CountingResource counter;
+    ItchDecoder decoder(1, &counter);
+    std::size_t events = 0;
+    auto sink = [&](const HistoricalEvent&) { ++events; };
+
+    decoder.decode(session(1), sink);
+    REQUIRE(decoder.live_orders() == 0);
+    counter.reset();
+
+    decoder.decode(session(5000), sink);
+    REQUIRE(events == 4000);
+    REQUIRE(counter.allocations() == 0);
+}
+
+TEST_CASE("Loader streams an mmap'd file into replay", "[loader]") {
+    const std::string path = "test_historical_loader.csv";
+    {
+        std::ofstream f(path);
+        f << "1,LIMIT,1,S,100,10,1\n"
+          << "2,LIMIT,2,B,99,5,2\n"
+          << "3,LIMIT,3,B,100,4,3\n"
+          << "4,CANCEL,2,B,0,0,4\n";
+    }
+
+    PaperTradingEngine paper(1024);
+    auto stats = load_csv_file(path, [&](const HistoricalEvent& e) { paper.feed_event(e); });
+    std::remove(path.c_str());
+
+    REQUIRE(stats.events == 4);
+    REQUIRE(paper.trades().size() == 1);
+    REQUIRE(paper.trades()[0].quantity == 4);
+    REQUIRE(paper.analytics().size() == 4);
+
+    MappedFile missing("does_not_exist.csv");
+    REQUIRE_FALSE(missing.is_open());
+}
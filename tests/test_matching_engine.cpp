@@ -23,4 +23,78 @@ TEST_CASE("Single cross") {
     REQUIRE(trades.size() == 1);
     REQUIRE(trades[0].quantity == 10);
     REQUIRE(engine.book().size() == 0);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Modify only matches when the new price crosses") {
+    MatchingEngine engine(1024);
+    std::vector<TradeEvent> trades;
+
+    engine.book().add_limit_order_no_match(1, Side::Sell, 105, 10, 1);
+    engine.book().add_limit_order_no_match(2, Side::Buy, 100, 10, 2);
+
+    // Non-crossing price change: requeue, no trades
+    REQUIRE(engine.modify_order(2, 103, 10, 3, trades));
+    REQUIRE(trades.empty());
+    REQUIRE(engine.book().bids().begin()->first == 103);
+
+    // Size-down in place
+    REQUIRE(engine.modify_order(2, 103, 6, 4, trades));
+    REQUIRE(trades.empty());
+    REQUIRE(engine.book().total_volume() == 16);
+
+    // Crossing price change: goes through the matcher
+    REQUIRE(engine.modify_order(2, 105, 6, 5, trades));
+    REQUIRE(trades.size() == 1);
+    REQUIRE(trades[0].resting_order_id == 1);
+    REQUIRE(trades[0].incoming_order_id == 2);
+    REQUIRE(trades[0].quantity == 6);
+    REQUIRE(engine.book().size() == 1);
+    REQUIRE(engine.book().order_index().count(2) == 0);
+
+    REQUIRE_FALSE(engine.modify_order(2, 105, 6, 6, trades));
+}
+
+TEST_CASE("Both sides sweep from the best price") {
+    MatchingEngine engine(1024);
+    engine.book().add_limit_order_no_match(1, Side::Buy, 99, 10, 1);
+    engine.book().add_limit_order_no_match(2, Side::Buy, 101, 10, 2);
+    engine.book().add_limit_order_no_match(3, Side::Buy, 100, 10, 3);
+    engine.book().add_limit_order_no_match(4, Side::Sell, 104, 10, 4);
+    engine.book().add_limit_order_no_match(5, Side::Sell, 102, 10, 5);
+
+    REQUIRE(engine.book().best_bid()->price == 101);
+    REQUIRE(engine.book().best_ask()->price == 102);
+
+    // Sell 15 @ 100: 10 @ 101, then 5 @ 100; the 99 bid is out of reach
+    auto* sell = engine.book().pool().allocate();
+    sell->id = 6;
+    sell->side = Side::Sell;
+    sell->price = 100;
+    sell->qty = 15;
+    sell->remaining = 15;
+    sell->ts = 6;
+    auto trades = engine.match_limit_order(sell);
+
+    REQUIRE(trades.size() == 2);
+    REQUIRE(trades[0].resting_order_id == 2);
+    REQUIRE(trades[0].price == 101);
+    REQUIRE(trades[1].resting_order_id == 3);
+    REQUIRE(trades[1].price == 100);
+    REQUIRE(trades[1].quantity == 5);
+    REQUIRE(engine.book().best_bid()->price == 100);
+
+    // Buy 20 @ 104: 102 first, then 104
+    auto* buy = engine.book().pool().allocate();
+    buy->id = 7;
+    buy->side = Side::Buy;
+    buy->price = 104;
+    buy->qty = 20;
+    buy->remaining = 20;
+    buy->ts = 7;
+    trades = engine.match_limit_order(buy);
+
+    REQUIRE(trades.size() == 2);
+    REQUIRE(trades[0].price == 102);
+    REQUIRE(trades[1].price == 104);
+    REQUIRE(engine.book().asks().empty());
+}
@@ -0,0 +1,125 @@
+#include <catch2/catch_test_macros.hpp>
+#include "lob/memory_resources.hpp"
+#include "lob/paper_trader.hpp"
+#include "lob/pipelined_replay.hpp"
+#include "lob/strategy_engine.hpp"
+#include <iostream>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+// One round: two-sided quotes over `levels` prices, an aggressive order
+// that sweeps part of the asks, then cancels for whatever is left
+void append_round(std::vector<HistoricalEvent>& events, OrderId& next_id, Timestamp& ts, Price levels)
+{
+    const OrderId first = next_id;
+    for (Price i = 0; i < levels; ++i) {
+        events.push_back({next_id, EventType::LIMIT, next_id, Side::Buy, 1000 - i, 10, ts++});
+        ++next_id;
+        events.push_back({next_id, EventType::LIMIT, next_id, Side::Sell, 1001 + i, 10, ts++});
+        ++next_id;
+    }
+    events.push_back({next_id, EventType::LIMIT, next_id, Side::Buy, 1001 + levels / 2, 35, ts++});
+    ++next_id;
+    events.push_back({next_id, EventType::MODIFY, first, Side::Buy, 1000, 4, ts++});
+    ++next_id;
+    const OrderId last = next_id;
+    for (OrderId id = first; id < last; ++id) {
+        events.push_back({next_id++, EventType::CANCEL, id, Side::Buy, 0, 0, ts++});
+    }
+}
+
+} // namespace
+
+TEST_CASE("Counting resource sees every upstream allocation", "[memory]") {
+    CountingResource counter;
+    {
+        OrderBook book(16, &counter);
+        REQUIRE(counter.allocations() > 0);   // pool storage, index slots
+
+        counter.reset();
+        book.add_limit_order_no_match(1, Side::Buy, 100, 5, 1);
+        REQUIRE(counter.allocations() == 1);  // the level node; index slots are preallocated
+        REQUIRE(book.resource() == &counter);
+    }
+    REQUIRE(counter.deallocations() > 0);
+}
+
+TEST_CASE("Warm book makes no allocations in steady state", "[memory]") {
+    CountingResource counter;
+    NodePool nodes(&counter);
+    CountingResource arena_upstream;
+    ReplayArena arena(1 << 16, &arena_upstream);
+
+    constexpr int kRounds = 200;
+    std::vector<HistoricalEvent> warm_up;
+    std::vector<HistoricalEvent> session;
+    OrderId next_id = 1;
+    Timestamp ts = 1;
+    append_round(warm_up, next_id, ts, 64);
+    for (int r = 0; r < kRounds; ++r) append_round(session, next_id, ts, 64);
+
+    MatchingEngine engine(4096, &nodes);
+    PaperTradingEngine paper(engine);
+    TradeBuffer trades(&arena);
+    AnalyticsBuffer analytics(&arena);
+
+    paper.feed_events(warm_up, trades, analytics);
+    REQUIRE(counter.allocations() > 0);
+
+    counter.reset();
+    paper.feed_events(session, trades, analytics);
+
+    std::cout << "Steady-state upstream allocations over " << session.size()
+              << " events: " << counter.allocations() << "\n";
+    REQUIRE(counter.allocations() == 0);
+
+    // The replay output went to the arena, and the run actually traded
+    REQUIRE(trades.size() > static_cast<std::size_t>(kRounds));
+    REQUIRE(analytics.size() == warm_up.size() + session.size());
+    REQUIRE(paper.trades().empty());
+    REQUIRE(arena_upstream.allocations() > 0);
+    REQUIRE(engine.book().size() == 0);
+}
+
+TEST_CASE("Strategy and pipelined replays allocate from the given resource", "[memory]") {
+    struct Volume {
+        Quantity traded = 0;
+        void on_trade(const TradeEvent& t) { traded += t.quantity; }
+    };
+
+    std::vector<HistoricalEvent> events;
+    OrderId next_id = 1;
+    Timestamp ts = 1;
+    append_round(events, next_id, ts, 16);
+
+    CountingResource strategy_mr;
+    StrategyEngine<Volume> strategy(std::allocator_arg, &strategy_mr, 1024);
+    REQUIRE(strategy.trades().get_allocator().resource() == &strategy_mr);
+    REQUIRE(strategy.engine().book().resource() == &strategy_mr);
+
+    strategy.feed_events(events);
+    REQUIRE(strategy.strategy().traded > 0);
+
+    // Nothing after construction reaches the default resource
+    CountingResource fallback;
+    std::pmr::memory_resource* previous = std::pmr::set_default_resource(&fallback);
+    strategy.feed_events(events);
+
+    CountingResource replay_mr;
+    MatchingEngine engine(1024, &strategy_mr);
+    {
+        PipelinedReplay replay(engine, 256, 64, &replay_mr);
+        replay.run([&events](auto&& sink) {
+            for (const auto& e : events) sink(e);
+        });
+        REQUIRE(replay.trades().get_allocator().resource() == &replay_mr);
+        REQUIRE(replay.analytics().size() == events.size());
+    }
+    std::pmr::set_default_resource(previous);
+
+    REQUIRE(fallback.allocations() == 0);
+    REQUIRE(replay_mr.allocations() > 0);
+}
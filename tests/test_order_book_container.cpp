@@ -115,4 +115,45 @@ TEST_CASE("Bid and ask are independent", "[orderbook]") {
 
     REQUIRE(bid->price == 100);
     REQUIRE(ask->price == 105);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Size-down modify keeps queue priority", "[orderbook]") {
+    OrderBook book(1024);
+
+    auto* o1 = book.add_limit_order_no_match(1, Side::Buy, 100, 10, 1);
+    auto* o2 = book.add_limit_order_no_match(2, Side::Buy, 100, 20, 2);
+
+    REQUIRE(book.modify_order(1, 100, 4) == true);
+
+    const PriceLevel* best = book.best_bid();
+    REQUIRE(best->head == o1);
+    REQUIRE(best->tail == o2);
+    REQUIRE(o1->remaining == 4);
+    REQUIRE(o1->qty == 10);
+    REQUIRE(best->total_volume == 24);
+    REQUIRE(book.total_volume() == 24);
+}
+
+TEST_CASE("Size-up or price change modify requeues at tail", "[orderbook]") {
+    OrderBook book(1024);
+
+    auto* o1 = book.add_limit_order_no_match(1, Side::Buy, 100, 10, 1);
+    auto* o2 = book.add_limit_order_no_match(2, Side::Buy, 100, 20, 2);
+
+    REQUIRE(book.modify_order(1, 100, 15) == true);
+
+    const PriceLevel* best = book.best_bid();
+    REQUIRE(best->head == o2);
+    REQUIRE(best->tail == o1);
+    REQUIRE(best->total_volume == 35);
+
+    REQUIRE(book.modify_order(2, 99, 20) == true);
+    REQUIRE(book.bids().size() == 2);
+    REQUIRE(book.bids().at(100).head == o1);
+    REQUIRE(book.bids().at(99).head == o2);
+
+    // Zero quantity cancels
+    REQUIRE(book.modify_order(2, 99, 0) == true);
+    REQUIRE(book.size() == 1);
+    REQUIRE(book.modify_order(2, 99, 5) == false);
+}
@@ -0,0 +1,226 @@
+#include <catch2/catch_test_macros.hpp>
+#include "lob/strategy_engine.hpp"
+#include <random>
+
+using namespace lob;
+
+namespace {
+
+// Reference answer: walk the level from the head
+QueuePosition walk_position(const OrderBook& book, const Order* order)
+{
+    const PriceLevel& level = (order->side == Side::Buy) ? book.bids().at(order->price)
+                                                         : book.asks().at(order->price);
+    QueuePosition pos{0, 0};
+    for (const Order* o = level.head; o != order; o = o->next) {
+        ++pos.orders_ahead;
+        pos.volume_ahead += o->remaining;
+    }
+    return pos;
+}
+
+Order* limit(MatchingEngine& engine, OrderId id, Side side, Price price, Quantity qty, bool tracked = false)
+{
+    Order* o = engine.book().pool().allocate();
+    o->id = id;
+    o->side = side;
+    o->price = price;
+    o->qty = qty;
+    o->remaining = qty;
+    o->ts = id;
+    o->tracked = tracked;
+    engine.match_limit_order(o);
+    return o;
+}
+
+struct Quoter {
+    OrderGateway* gw = nullptr;
+    OrderId my_order = 0;
+    Quantity filled = 0;
+
+    void on_attach(OrderGateway& g) { gw = &g; }
+
+    void on_book_update(const OrderBook&, const HistoricalEvent& e) {
+        if (my_order == 0 && e.id == 1) {
+            my_order = gw->submit_limit(Side::Buy, 100, 5);
+        }
+    }
+
+    void on_trade(const TradeEvent& t) {
+        if (t.resting_order_id == my_order || t.incoming_order_id == my_order) filled += t.quantity;
+    }
+};
+
+} // namespace
+
+TEST_CASE("Queue position is maintained incrementally", "[queue]") {
+    MatchingEngine engine(1024);
+    OrderBook& book = engine.book();
+
+    limit(engine, 1, Side::Buy, 100, 10);
+    limit(engine, 2, Side::Buy, 100, 20);
+    Order* me = limit(engine, 3, Side::Buy, 100, 7, true);
+    limit(engine, 4, Side::Buy, 100, 40);
+
+    auto pos = book.queue_position(3);
+    REQUIRE(pos.has_value());
+    REQUIRE(pos->orders_ahead == 2);
+    REQUIRE(pos->volume_ahead == 30);
+    REQUIRE_FALSE(book.queue_position(4).has_value());   // not tracked
+
+    // Orders behind do not move us
+    book.cancel_order(4);
+    REQUIRE(book.queue_position(3)->volume_ahead == 30);
+
+    // Partial fill at the head
+    limit(engine, 5, Side::Sell, 100, 4);
+    REQUIRE(book.queue_position(3)->orders_ahead == 2);
+    REQUIRE(book.queue_position(3)->volume_ahead == 26);
+
+    // Cancel ahead
+    book.cancel_order(2);
+    REQUIRE(book.queue_position(3)->orders_ahead == 1);
+    REQUIRE(book.queue_position(3)->volume_ahead == 6);
+
+    // Fill through to us
+    limit(engine, 6, Side::Sell, 100, 8);
+    REQUIRE(book.queue_position(3)->orders_ahead == 0);
+    REQUIRE(book.queue_position(3)->volume_ahead == 0);
+    REQUIRE(me->remaining == 5);
+}
+
+TEST_CASE("Queue position matches a level walk under random flow", "[queue]") {
+    MatchingEngine engine(1 << 14);
+    OrderBook& book = engine.book();
+
+    std::mt19937 rng(99);
+    std::uniform_int_distribution<int> action(0, 9);
+    std::uniform_int_distribution<int> price_dist(98, 102);
+    std::uniform_int_distribution<int> qty_dist(1, 15);
+
+    std::vector<OrderId> tracked;
+    OrderId next_id = 1;
+
+    for (int step = 0; step < 5000; ++step) {
+        int a = action(rng);
+        if (a < 6) {
+            // Passive-ish flow on both sides around 100
+            Side side = (a % 2 == 0) ? Side::Buy : Side::Sell;
+            Price px = price_dist(rng);
+            bool track = (a == 0);
+            limit(engine, next_id, side, px, qty_dist(rng), track);
+            if (track) tracked.push_back(next_id);
+            ++next_id;
+        } else if (a < 8 && next_id > 1) {
+            std::uniform_int_distribution<OrderId> id_dist(1, next_id - 1);
+            book.cancel_order(id_dist(rng));
+        } else if (next_id > 1) {
+            std::uniform_int_distribution<OrderId> id_dist(1, next_id - 1);
+            OrderId id = id_dist(rng);
+            if (book.track_queue(id)) tracked.push_back(id);
+        }
+
+        for (OrderId id : tracked) {
+            auto it = book.order_index().find(id);
+            if (it == book.order_index().end()) continue;
+            auto pos = book.queue_position(id);
+            REQUIRE(pos.has_value());
+            auto ref = walk_position(book, it->second);
+            REQUIRE(pos->orders_ahead == ref.orders_ahead);
+            REQUIRE(pos->volume_ahead == ref.volume_ahead);
+        }
+    }
+}
+
+TEST_CASE("Strategy orders arrive after the simulated latency", "[gateway]") {
+    StrategyEngine<Quoter> engine(1024);
+    engine.gateway().set_latency(5);
+
+    std::vector<HistoricalEvent> events = {
+        {1, EventType::LIMIT, 1, Side::Buy, 100, 10, 10},   // strategy submits here, arrives at 15
+        {2, EventType::LIMIT, 2, Side::Buy, 100, 3, 15},    // same time as arrival: goes first
+        {3, EventType::LIMIT, 3, Side::Buy, 100, 4, 16},    // strategy order is in before this
+    };
+    engine.feed_events(events);
+
+    OrderId mine = engine.strategy().my_order;
+    REQUIRE(OrderGateway::is_strategy_order(mine));
+    REQUIRE(engine.gateway().pending() == 0);
+
+    auto pos = engine.gateway().queue_position(mine);
+    REQUIRE(pos.has_value());
+    REQUIRE(pos->orders_ahead == 2);
+    REQUIRE(pos->volume_ahead == 13);
+
+    // Sell through the queue: 13 ahead of us, then our 5
+    engine.feed_event({4, EventType::LIMIT, 4, Side::Sell, 100, 15, 20});
+    REQUIRE(engine.strategy().filled == 2);
+    REQUIRE(engine.gateway().queue_position(mine)->volume_ahead == 0);
+}
+
+TEST_CASE("Strategy cancels and flush", "[gateway]") {
+    struct Canceller {
+        OrderGateway* gw = nullptr;
+        void on_attach(OrderGateway& g) { gw = &g; }
+    };
+
+    StrategyEngine<Canceller> engine(1024);
+    engine.gateway().set_latency(100);
+
+    OrderId id = engine.gateway().submit_limit(Side::Sell, 105, 10);
+    engine.feed_event({1, EventType::LIMIT, 1, Side::Buy, 100, 1, 50});
+    REQUIRE(engine.engine().book().size() == 1);   // still in flight
+
+    engine.feed_event({2, EventType::LIMIT, 2, Side::Buy, 100, 1, 101});
+    REQUIRE(engine.engine().book().order_index().count(id) == 1);
+
+    engine.gateway().cancel(id);
+    REQUIRE(engine.gateway().pending() == 1);
+    engine.flush_orders();
+    REQUIRE(engine.engine().book().order_index().count(id) == 0);
+}
+
+TEST_CASE("Shadow orders follow the market without touching it", "[gateway]") {
+    MatchingEngine market(1024);
+    StrategyEngine<Quoter> follower(market);
+    follower.follow_market();
+    follower.gateway().set_latency(5);
+
+    TradeBuffer prints;
+    auto step = [&](const HistoricalEvent& e) {
+        follower.before_market_event(e);
+        prints.clear();
+        apply_event(market, e, prints);
+        follower.after_market_event(e, prints);
+    };
+
+    step({1, EventType::LIMIT, 1, Side::Buy, 100, 10, 10});   // strategy submits, arrives at 15
+    step({2, EventType::LIMIT, 2, Side::Buy, 100, 3, 15});
+    step({3, EventType::LIMIT, 3, Side::Buy, 100, 4, 16});
+
+    const OrderId mine = follower.strategy().my_order;
+    REQUIRE(market.book().size() == 3);
+    REQUIRE(market.book().order_index().count(mine) == 0);
+    REQUIRE(follower.gateway().queue_position(mine)->volume_ahead == 13);
+
+    // Same prints as the live case: 13 ahead of us, then 2 of our 5
+    step({4, EventType::LIMIT, 4, Side::Sell, 100, 15, 20});
+    REQUIRE(follower.strategy().filled == 2);
+    REQUIRE(follower.gateway().queue_position(mine)->volume_ahead == 0);
+
+    // 2 more print at our price, then the sell rests at 99, through us
+    step({5, EventType::LIMIT, 5, Side::Sell, 99, 10, 30});
+    REQUIRE(follower.strategy().filled == 5);
+    REQUIRE(follower.gateway().shadow_orders() == 0);
+    REQUIRE_FALSE(follower.gateway().queue_position(mine).has_value());
+    REQUIRE(market.book().best_ask()->total_volume == 8);
+
+    // A crossing order takes the visible asks on arrival and leaves them there
+    const OrderId taker = follower.gateway().submit_limit(Side::Buy, 101, 4);
+    step({6, EventType::CANCEL, 3, Side::Buy, 0, 0, 40});
+    const TradeEvent& t = follower.trades().back();
+    REQUIRE(t.incoming_order_id == taker);
+    REQUIRE(t.price == 99);
+    REQUIRE(t.quantity == 4);
+    REQUIRE(market.book().best_ask()->total_volume == 8);
+}
@@ -0,0 +1,226 @@
+#include <catch2/catch_test_macros.hpp>
+#include "lob/parameter_sweep.hpp"
+#include "lob/flow_generator.hpp"
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+// Quotes one bid `offset` ticks under the first mid it sees and requotes
+// after every fill; results are fills and traded volume
+struct Quoter {
+    Price offset;
+    OrderGateway* gw = nullptr;
+    OrderId live = 0;
+    std::size_t fills = 0;
+    Quantity volume = 0;
+    std::size_t batches = 0;
+
+    void on_attach(OrderGateway& g) { gw = &g; }
+
+    void on_book_update(const OrderBook& book, const HistoricalEvent&) {
+        if (live != 0 || !book.best_bid()) return;
+        live = gw->submit_limit(Side::Buy, book.best_bid()->price - offset, 10);
+    }
+
+    void on_trade(const TradeEvent& t) {
+        if (t.resting_order_id == live || t.incoming_order_id == live) {
+            ++fills;
+            volume += t.quantity;
+            if (!gw->queue_position(live)) live = 0;   // fully filled
+        }
+    }
+
+    void on_event_batch(std::span<const HistoricalEvent>) { ++batches; }
+};
+
+std::vector<HistoricalEvent> make_flow(std::size_t n)
+{
+    FlowConfig cfg;
+    cfg.seed = 21;
+    cfg.marketable_ratio = 0.2;
+    FlowGenerator flow(cfg);
+    std::vector<HistoricalEvent> events(n);
+    flow.generate(events);
+    return events;
+}
+
+} // namespace
+
+TEST_CASE("Sweep instances match independent replays", "[sweep]") {
+    const auto events = make_flow(20000);
+    const std::vector<Price> offsets = {0, 1, 2, 3, 5, 8, 13};
+
+    SweepOptions opts;
+    opts.threads = 3;
+    opts.batch_events = 777;
+    opts.keep_records = true;
+    ParameterSweep<Quoter> sweep(offsets.size(), [&](std::size_t i) { return Quoter{offsets[i]}; }, opts);
+    sweep.run(events);
+
+    for (std::size_t i = 0; i < offsets.size(); ++i) {
+        StrategyEngine<Quoter> single(opts.pool_size, Quoter{offsets[i]});
+        for (std::size_t b = 0; b < events.size(); b += opts.batch_events) {
+            const std::size_t n = std::min(opts.batch_events, events.size() - b);
+            single.feed_events(std::span<const HistoricalEvent>(events).subspan(b, n));
+        }
+
+        const auto& got = sweep.instance(i);
+        REQUIRE(got.strategy().fills == single.strategy().fills);
+        REQUIRE(got.strategy().volume == single.strategy().volume);
+        REQUIRE(got.strategy().batches == (events.size() + opts.batch_events - 1) / opts.batch_events);
+        REQUIRE(got.trades().size() == single.trades().size());
+        REQUIRE(got.analytics().size() == events.size());
+    }
+
+    auto volumes = sweep.collect([](const auto& inst) { return inst.strategy().volume; });
+    REQUIRE(volumes.size() == offsets.size());
+    REQUIRE(volumes[0] > 0);
+}
+
+TEST_CASE("Sweep threading does not change results", "[sweep]") {
+    const auto events = make_flow(10000);
+    auto make = [](std::size_t i) { return Quoter{static_cast<Price>(i % 4)}; };
+
+    SweepOptions serial;
+    serial.threads = 1;
+    ParameterSweep<Quoter> a(16, make, serial);
+    a.run(events);
+
+    SweepOptions parallel;
+    parallel.threads = 4;
+    parallel.batch_events = 512;
+    ParameterSweep<Quoter> b(16, make, parallel);
+    b.run([&](auto&& sink) {
+        for (const auto& e : events) sink(e);
+    });
+
+    for (std::size_t i = 0; i < 16; ++i) {
+        REQUIRE(a.instance(i).strategy().fills == b.instance(i).strategy().fills);
+        REQUIRE(a.instance(i).strategy().volume == b.instance(i).strategy().volume);
+        REQUIRE(b.instance(i).trades().empty());   // records dropped per batch
+    }
+
+    // Empty stream is a no-op
+    b.run(std::span<const HistoricalEvent>());
+}
+
+TEST_CASE("Shared-market instances match a single follower", "[sweep]") {
+    const auto events = make_flow(20000);
+    const std::vector<Price> offsets = {0, 1, 2, 3, 5, 8, 13};
+
+    SweepOptions opts;
+    opts.threads = 3;
+    opts.batch_events = 777;
+    opts.keep_records = true;
+    opts.shared_market = true;
+    ParameterSweep<Quoter> sweep(offsets.size(), [&](std::size_t i) { return Quoter{offsets[i]}; }, opts);
+    sweep.run(events);
+
+    std::size_t filled = 0;
+    for (std::size_t i = 0; i < offsets.size(); ++i) {
+        MatchingEngine market(opts.pool_size);
+        StrategyEngine<Quoter> single(market, Quoter{offsets[i]});
+        single.follow_market();
+        TradeBuffer prints;
+        for (const auto& e : events) {
+            single.before_market_event(e);
+            prints.clear();
+            apply_event(market, e, prints);
+            single.after_market_event(e, prints);
+        }
+
+        const auto& got = sweep.instance(i);
+        REQUIRE(got.strategy().fills == single.strategy().fills);
+        REQUIRE(got.strategy().volume == single.strategy().volume);
+        REQUIRE(got.strategy().batches == (events.size() + opts.batch_events - 1) / opts.batch_events);
+        REQUIRE(got.trades().size() == single.trades().size());   // own fills only
+        REQUIRE(got.analytics().empty());
+        filled += got.strategy().fills;
+    }
+    REQUIRE(filled > 0);
+
+    // Threading does not change results
+    SweepOptions serial = opts;
+    serial.threads = 1;
+    ParameterSweep<Quoter> one(offsets.size(), [&](std::size_t i) { return Quoter{offsets[i]}; }, serial);
+    one.run(events);
+    for (std::size_t i = 0; i < offsets.size(); ++i) {
+        REQUIRE(one.instance(i).strategy().volume == sweep.instance(i).strategy().volume);
+    }
+}
+
+TEST_CASE("Shared market rejects strategies that drive the engine", "[sweep]") {
+    struct Driver {
+        void before_event(const HistoricalEvent&, TradeBuffer&) {}
+    };
+    SweepOptions opts;
+    opts.shared_market = true;
+    REQUIRE_THROWS_AS(ParameterSweep<Driver>(2, [](std::size_t) { return Driver{}; }, opts),
+                      std::invalid_argument);
+}
+
+TEST_CASE("Sweep failures are rethrown after the workers stop", "[sweep]") {
+    const auto events = make_flow(5000);
+    auto make = [](std::size_t i) { return Quoter{static_cast<Price>(i % 4)}; };
+
+    SweepOptions opts;
+    opts.threads = 3;
+    opts.batch_events = 256;
+
+    // The source fails mid-stream
+    ParameterSweep<Quoter> a(6, make, opts);
+    REQUIRE_THROWS_AS(a.run([&](auto&& sink) {
+        for (std::size_t i = 0; i < 1000; ++i) sink(events[i]);
+        throw std::runtime_error("feed lost");
+    }), std::runtime_error);
+
+    // A strategy fails on a worker; the source is abandoned
+    struct Fragile {
+        std::size_t seen = 0;
+        void on_trade(const TradeEvent&) { if (++seen == 50) throw std::logic_error("strategy bug"); }
+    };
+    ParameterSweep<Fragile> b(6, [](std::size_t) { return Fragile{}; }, opts);
+    std::size_t fed = 0;
+    REQUIRE_THROWS_AS(b.run([&](auto&& sink) {
+        for (const auto& e : events) { sink(e); ++fed; }
+    }), std::logic_error);
+    REQUIRE(fed < events.size());
+
+    // Both sweeps are still usable afterwards
+    a.run(std::span<const HistoricalEvent>(events).first(100));
+}
+
+TEST_CASE("Sweep cost versus separate replays", "[sweep][perf]") {
+    const auto events = make_flow(50000);
+    constexpr std::size_t K = 32;
+    auto make = [](std::size_t i) { return Quoter{static_cast<Price>(i % 8)}; };
+
+    auto t0 = std::chrono::steady_clock::now();
+    ParameterSweep<Quoter> sweep(K, make);
+    sweep.run(events);
+    const double swept = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    t0 = std::chrono::steady_clock::now();
+    StrategyEngine<Quoter> single(SweepOptions{}.pool_size, make(0));
+    single.feed_events(events);
+    const double one = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    SweepOptions opts;
+    opts.shared_market = true;
+    t0 = std::chrono::steady_clock::now();
+    ParameterSweep<Quoter> shared(K, make, opts);
+    shared.run(events);
+    const double followed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << K << " instances: " << swept << " s, shared market: " << followed
+              << " s, one replay: " << one
+              << " s (" << std::thread::hardware_concurrency() << " threads)\n";
+    REQUIRE(sweep.instance(0).strategy().fills == single.strategy().fills);
+    REQUIRE(shared.instance(0).strategy().volume > 0);
+    REQUIRE(shared.market_events() == events.size() * shared.workers());   // one match per worker, not per instance
+}
@@ -0,0 +1,148 @@
+#include <catch2/catch_test_macros.hpp>
+#include "lob/matching_engine.hpp"
+#include <random>
+
+using namespace lob;
+
+namespace {
+
+Order* limit(MatchingEngine& engine, OrderId id, Side side, Price price, Quantity qty,
+             ParticipantId owner, std::vector<TradeEvent>* trades = nullptr)
+{
+    Order* o = engine.book().pool().allocate();
+    o->id = id;
+    o->side = side;
+    o->price = price;
+    o->qty = qty;
+    o->remaining = qty;
+    o->owner = owner;
+    o->ts = id;
+    auto t = engine.match_limit_order(o);
+    if (trades) trades->insert(trades->end(), t.begin(), t.end());
+    return o;
+}
+
+} // namespace
+
+TEST_CASE("Participant exposure is maintained incrementally", "[participant]") {
+    MatchingEngine engine(1024);
+    OrderBook& book = engine.book();
+
+    REQUIRE(book.participant(7) == nullptr);
+
+    book.add_limit_order_no_match(1, Side::Buy, 100, 10, 1, 7);
+    book.add_limit_order_no_match(2, Side::Buy, 100, 5, 2, 7);
+    book.add_limit_order_no_match(3, Side::Sell, 105, 4, 3, 7);
+    book.add_limit_order_no_match(4, Side::Buy, 100, 8, 4, 9);
+
+    const ParticipantState* p = book.participant(7);
+    REQUIRE(p != nullptr);
+    REQUIRE(p->open_orders == 3);
+    REQUIRE(p->open_buy_qty == 15);
+    REQUIRE(p->open_sell_qty == 4);
+    REQUIRE(p->open_notional == 100 * 10 + 100 * 5 + 105 * 4);
+
+    // Partial fill against participant 7's best bid
+    limit(engine, 5, Side::Sell, 100, 6, 0);
+    REQUIRE(p->open_orders == 3);
+    REQUIRE(p->open_buy_qty == 9);
+    REQUIRE(p->open_notional == 100 * 4 + 100 * 5 + 105 * 4);
+
+    REQUIRE(book.cancel_order(2));
+    REQUIRE(p->open_orders == 2);
+    REQUIRE(p->open_buy_qty == 4);
+
+    REQUIRE(book.participant(9)->open_orders == 1);
+}
+
+TEST_CASE("Mass cancel by participant leaves others untouched", "[participant]") {
+    MatchingEngine engine(1 << 12);
+    OrderBook& book = engine.book();
+
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> price_dist(90, 110);
+    for (OrderId id = 1; id <= 1000; ++id) {
+        ParticipantId owner = static_cast<ParticipantId>(id % 4 + 1);
+        Side side = (id % 2 == 0) ? Side::Buy : Side::Sell;
+        // Keep sides apart so nothing matches
+        Price px = side == Side::Buy ? price_dist(rng) : price_dist(rng) + 30;
+        book.add_limit_order_no_match(id, side, px, 10, id, owner);
+    }
+
+    REQUIRE(book.participant(2)->open_orders == 250);
+    REQUIRE(book.cancel_participant(2) == 250);
+    REQUIRE(book.participant(2)->open_orders == 0);
+    REQUIRE(book.participant(2)->open_notional == 0);
+    REQUIRE(book.participant(2)->head == nullptr);
+    REQUIRE(book.size() == 750);
+    REQUIRE(book.total_volume() == 7500);
+
+    for (const auto& [id, order] : book.order_index()) REQUIRE(order->owner != 2);
+    REQUIRE(book.cancel_participant(2) == 0);
+    REQUIRE(book.cancel_participant(42) == 0);
+}
+
+TEST_CASE("Self-trade prevention modes", "[participant][stp]") {
+    SECTION("None allows self-trades") {
+        MatchingEngine engine(64);
+        std::vector<TradeEvent> trades;
+        limit(engine, 1, Side::Sell, 100, 10, 5);
+        limit(engine, 2, Side::Buy, 100, 4, 5, &trades);
+        REQUIRE(trades.size() == 1);
+    }
+
+    SECTION("CancelNewest drops the incoming remainder") {
+        MatchingEngine engine(64);
+        engine.set_self_trade_prevention(SelfTradePrevention::CancelNewest);
+        std::vector<TradeEvent> trades;
+        limit(engine, 1, Side::Sell, 100, 3, 6);   // other participant, first in queue
+        limit(engine, 2, Side::Sell, 100, 10, 5);
+        limit(engine, 3, Side::Buy, 100, 8, 5, &trades);
+
+        REQUIRE(trades.size() == 1);
+        REQUIRE(trades[0].resting_order_id == 1);
+        REQUIRE(engine.book().size() == 1);        // only the own resting sell
+        REQUIRE(engine.book().order_index().count(2) == 1);
+        REQUIRE(engine.book().participant(5)->open_sell_qty == 10);
+    }
+
+    SECTION("CancelOldest removes resting and keeps matching") {
+        MatchingEngine engine(64);
+        engine.set_self_trade_prevention(SelfTradePrevention::CancelOldest);
+        std::vector<TradeEvent> trades;
+        limit(engine, 1, Side::Sell, 100, 10, 5);
+        limit(engine, 2, Side::Sell, 100, 3, 6);
+        limit(engine, 3, Side::Buy, 100, 8, 5, &trades);
+
+        REQUIRE(trades.size() == 1);
+        REQUIRE(trades[0].resting_order_id == 2);
+        REQUIRE(trades[0].quantity == 3);
+        REQUIRE(engine.book().order_index().count(1) == 0);
+        REQUIRE(engine.book().order_index().count(3) == 1);   // rests with 5
+        REQUIRE(engine.book().participant(5)->open_buy_qty == 5);
+        REQUIRE(engine.book().participant(5)->open_sell_qty == 0);
+    }
+
+    SECTION("DecrementBoth reduces both without a trade") {
+        MatchingEngine engine(64);
+        engine.set_self_trade_prevention(SelfTradePrevention::DecrementBoth);
+        std::vector<TradeEvent> trades;
+        Order* resting = limit(engine, 1, Side::Sell, 100, 10, 5);
+        limit(engine, 2, Side::Buy, 100, 4, 5, &trades);
+
+        REQUIRE(trades.empty());
+        REQUIRE(resting->remaining == 6);
+        REQUIRE(engine.book().size() == 1);
+        REQUIRE(engine.book().best_ask()->total_volume == 6);
+        REQUIRE(engine.book().participant(5)->open_sell_qty == 6);
+    }
+
+    SECTION("Anonymous orders are never self-trade checked") {
+        MatchingEngine engine(64);
+        engine.set_self_trade_prevention(SelfTradePrevention::CancelNewest);
+        std::vector<TradeEvent> trades;
+        limit(engine, 1, Side::Sell, 100, 10, 0);
+        limit(engine, 2, Side::Buy, 100, 4, 0, &trades);
+        REQUIRE(trades.size() == 1);
+    }
+}
@@ -1,6 +1,8 @@
 #include "catch2/catch_test_macros.hpp"
 #include "lob/matching_engine.hpp"
+#include <algorithm>
 #include <random>
+#include <vector>
 #include <iostream>
 
 using namespace lob;
@@ -43,4 +45,15 @@ TEST_CASE("MatchingEngine performance metrics", "[perf]") {
     // Print pool allocation info
     std::cout << "Pool size: " << POOL_SIZE << "\n";
     std::cout << "Pool allocations: " << engine.book().pool().active() << "\n";
-}
\ No newline at end of file
+}
+TEST_CASE("Growing a wrapped latency window keeps the newest samples", "[perf]") {
+    PerfStats perf(std::pmr::get_default_resource(), 4);
+    for (int i = 1; i <= 6; ++i) perf.record(i);   // ring: 5 6 3 4
+
+    perf.reserve(6);
+    for (int i = 7; i <= 11; ++i) perf.record(i);   // evicts 3, 4, 5 in age order
+
+    std::vector<double> kept(perf.latencies_us.begin(), perf.latencies_us.end());
+    std::sort(kept.begin(), kept.end());
+    REQUIRE(kept == std::vector<double>{6, 7, 8, 9, 10, 11});
+}
@@ -0,0 +1,178 @@
+#include <catch2/catch_test_macros.hpp>
+#include "lob/paper_trader.hpp"
+#include "lob/pipelined_replay.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+using namespace lob;
+
+namespace {
+
+std::vector<HistoricalEvent> random_events(std::size_t n, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> type_dist(0, 9);
+    std::uniform_int_distribution<int> side_dist(0, 1);
+    std::uniform_int_distribution<int> price_dist(90, 110);
+    std::uniform_int_distribution<int> qty_dist(1, 20);
+
+    std::vector<HistoricalEvent> events;
+    events.reserve(n);
+    OrderId next_id = 1;
+
+    for (std::size_t i = 1; i <= n; ++i) {
+        HistoricalEvent e{};
+        e.id = i;
+        e.ts = i;
+        e.side = side_dist(rng) == 0 ? Side::Buy : Side::Sell;
+        e.price = price_dist(rng);
+        e.qty = qty_dist(rng);
+
+        int t = type_dist(rng);
+        if (t < 6 || next_id == 1) {
+            e.type = EventType::LIMIT;
+            e.order_id = next_id++;
+        } else {
+            std::uniform_int_distribution<OrderId> id_dist(1, next_id - 1);
+            e.type = (t < 8) ? EventType::CANCEL : EventType::MODIFY;
+            e.order_id = id_dist(rng);
+        }
+        events.push_back(e);
+    }
+    return events;
+}
+
+struct ThrowingTradeStrategy {
+    void on_trade(const TradeEvent&) { throw std::runtime_error("strategy failed"); }
+};
+
+struct ThrowingBookStrategy {
+    std::size_t seen{0};
+    void on_book_update(const OrderBook&, const HistoricalEvent&)
+    {
+        if (++seen == 100) throw std::runtime_error("strategy failed");
+    }
+};
+
+} // namespace
+
+TEST_CASE("SpscRing preserves FIFO order across threads", "[pipeline]") {
+    SpscRing<uint64_t> ring(8);
+    REQUIRE(ring.capacity() == 8);
+
+    const uint64_t N = 100000;
+    std::thread producer([&] {
+        for (uint64_t i = 0; i < N; ++i) ring.push(i);
+    });
+
+    bool in_order = true;
+    for (uint64_t i = 0; i < N; ++i) {
+        uint64_t v = 0;
+        ring.pop(v);
+        if (v != i) in_order = false;
+    }
+    producer.join();
+
+    REQUIRE(in_order);
+    uint64_t v = 0;
+    REQUIRE_FALSE(ring.try_pop(v));
+}
+
+TEST_CASE("Pipelined replay matches sequential replay", "[pipeline]") {
+    auto events = random_events(20000, 777);
+
+    PaperTradingEngine sequential(1 << 15);
+    PaperTradingEngine pipelined(1 << 15);
+
+    std::size_t callback_trades = 0;
+    pipelined.set_strategy_callback([&](const TradeEvent&) { ++callback_trades; });
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    sequential.feed_events(events);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    pipelined.feed_events_pipelined(events, 16);   // tiny rings exercise backpressure
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    const auto& a = sequential.trades();
+    const auto& b = pipelined.trades();
+    REQUIRE(a.size() > 0);
+    REQUIRE(a.size() == b.size());
+    REQUIRE(callback_trades == b.size());
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        REQUIRE(a[i].resting_order_id == b[i].resting_order_id);
+        REQUIRE(a[i].incoming_order_id == b[i].incoming_order_id);
+        REQUIRE(a[i].price == b[i].price);
+        REQUIRE(a[i].quantity == b[i].quantity);
+    }
+
+    const auto& sa = sequential.analytics();
+    const auto& sb = pipelined.analytics();
+    REQUIRE(sa.size() == events.size());
+    REQUIRE(sa.size() == sb.size());
+    for (std::size_t i = 0; i < sa.size(); ++i) {
+        REQUIRE(sa[i].ts == sb[i].ts);
+        REQUIRE(sa[i].mid_price == sb[i].mid_price);
+        REQUIRE(sa[i].total_volume == sb[i].total_volume);
+    }
+
+    std::cout << "Sequential replay: "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms\n";
+    std::cout << "Pipelined replay:  "
+              << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms\n";
+}
+
+TEST_CASE("Pipelined replay streams from a source callable", "[pipeline]") {
+    MatchingEngine engine(1024);
+    PipelinedReplay replay(engine, 4);
+
+    replay.run([](auto&& sink) {
+        sink(HistoricalEvent{1, EventType::LIMIT, 1, Side::Sell, 100, 10, 1});
+        sink(HistoricalEvent{2, EventType::LIMIT, 2, Side::Buy, 100, 4, 2});
+    });
+
+    REQUIRE(replay.trades().size() == 1);
+    REQUIRE(replay.trades()[0].quantity == 4);
+    REQUIRE(replay.analytics().size() == 2);
+    REQUIRE(replay.analytics()[1].total_volume == 6);
+    REQUIRE(engine.book().total_volume() == 6);
+}
+
+TEST_CASE("Pipelined replay rethrows stage failures after joining", "[pipeline]") {
+    auto events = random_events(20000, 4242);
+
+    SECTION("source") {
+        MatchingEngine engine(1024);
+        PipelinedReplay replay(engine, 4);
+        REQUIRE_THROWS_AS(replay.run([](auto&& sink) {
+            sink(HistoricalEvent{1, EventType::LIMIT, 1, Side::Sell, 100, 10, 1});
+            throw std::runtime_error("feed failed");
+        }), std::runtime_error);
+
+        // Events decoded before the failure are still applied and recorded
+        REQUIRE(replay.analytics().size() == 1);
+        REQUIRE(engine.book().total_volume() == 10);
+    }
+
+    SECTION("analytics stage strategy") {
+        MatchingEngine engine(1 << 15);
+        PipelinedReplay replay(engine, 4);
+        ThrowingTradeStrategy strategy;
+        REQUIRE_THROWS_AS(replay.run([&](auto&& sink) {
+            for (const auto& e : events) sink(e);
+        }, strategy), std::runtime_error);
+    }
+
+    SECTION("matching stage strategy") {
+        MatchingEngine engine(1 << 15);
+        PipelinedReplay replay(engine, 4);
+        ThrowingBookStrategy strategy;
+        REQUIRE_THROWS_AS(replay.run([&](auto&& sink) {
+            for (const auto& e : events) sink(e);
+        }, strategy), std::runtime_error);
+        REQUIRE(strategy.seen == 100);
+        REQUIRE(replay.analytics().size() == 100);
+    }
+}
@@ -0,0 +1,278 @@
+#include <catch2/catch_test_macros.hpp>
+#include "lob/matching_engine.hpp"
+#include "lob/paper_trader.hpp"
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+RiskResult limit(MatchingEngine& engine, OrderId id, Side side, Price price, Quantity qty,
+                 ParticipantId owner, TradeBuffer& trades, Timestamp ts = 0)
+{
+    Order* o = engine.book().pool().allocate();
+    o->id = id;
+    o->side = side;
+    o->price = price;
+    o->qty = qty;
+    o->remaining = qty;
+    o->owner = owner;
+    o->ts = ts ? ts : id;
+    return engine.submit_limit_order(o, trades);
+}
+
+} // namespace
+
+TEST_CASE("Order size and price collar", "[risk]") {
+    MatchingEngine engine(1024);
+    RiskEngine& risk = engine.enable_risk_checks(16);
+    TradeBuffer trades;
+
+    RiskLimits limits;
+    limits.max_order_qty = 100;
+    limits.price_collar = 5;
+    REQUIRE(risk.set_limits(7, limits));
+    REQUIRE_FALSE(risk.set_limits(16, limits));   // no slot
+    REQUIRE_FALSE(risk.set_limits(0, limits));    // anonymous
+
+    REQUIRE(limit(engine, 1, Side::Buy, 100, 101, 7, trades) == RiskResult::OrderSize);
+    REQUIRE(engine.book().size() == 0);
+    REQUIRE(engine.book().pool().active() == 0);   // rejected order went back to the pool
+
+    // Empty book, no trades yet: nothing to collar against, so refuse
+    REQUIRE(limit(engine, 2, Side::Sell, 200, 10, 7, trades) == RiskResult::NoReferencePrice);
+    REQUIRE(limit(engine, 20, Side::Sell, 200, 10, 0, trades) == RiskResult::Accepted);
+
+    // Buys are collared against the best ask, sells against the best bid
+    REQUIRE(limit(engine, 3, Side::Buy, 206, 10, 7, trades) == RiskResult::PriceCollar);
+    REQUIRE(limit(engine, 4, Side::Buy, 190, 10, 7, trades) == RiskResult::Accepted);
+    REQUIRE(limit(engine, 5, Side::Sell, 184, 10, 7, trades) == RiskResult::PriceCollar);
+    REQUIRE(limit(engine, 6, Side::Sell, 185, 5, 7, trades) == RiskResult::Accepted);
+    REQUIRE(trades.size() == 1);   // 185 sell hit the 190 bid
+
+    // Opposite side empty: the last trade (190) is the reference
+    REQUIRE(engine.book().cancel_order(20));
+    REQUIRE(limit(engine, 9, Side::Buy, 196, 10, 7, trades) == RiskResult::PriceCollar);
+    REQUIRE(limit(engine, 10, Side::Buy, 195, 10, 7, trades) == RiskResult::Accepted);
+
+    // Anonymous flow is never checked
+    REQUIRE(limit(engine, 7, Side::Buy, 500, 1000, 0, trades) == RiskResult::Accepted);
+
+    // Unregistered owners are refused by default, or let through unchecked
+    REQUIRE(limit(engine, 8, Side::Buy, 100, 1, 9, trades) == RiskResult::UnknownAccount);
+    risk.set_unknown_account_policy(UnknownAccountPolicy::Accept);
+    REQUIRE(limit(engine, 11, Side::Buy, 100, 1, 9, trades) == RiskResult::Accepted);
+
+    REQUIRE(risk.rejected(7) == 5);
+
+    // The void overload applies the same checks, it just drops the verdict
+    Order* o = engine.book().pool().allocate();
+    o->id = 12;
+    o->side = Side::Buy;
+    o->price = 100;
+    o->qty = 101;
+    o->remaining = 101;
+    o->owner = 7;
+    engine.match_limit_order(o, trades);
+    REQUIRE(engine.book().order_index().count(12) == 0);
+    REQUIRE(risk.rejected(7) == 6);
+}
+
+TEST_CASE("Open notional follows rests, fills and cancels", "[risk]") {
+    MatchingEngine engine(1024);
+    RiskEngine& risk = engine.enable_risk_checks(16);
+    TradeBuffer trades;
+
+    RiskLimits limits;
+    limits.max_open_notional = 100 * 30;
+    risk.set_limits(3, limits);
+
+    REQUIRE(limit(engine, 1, Side::Buy, 100, 20, 3, trades) == RiskResult::Accepted);
+    REQUIRE(limit(engine, 2, Side::Buy, 100, 11, 3, trades) == RiskResult::OpenNotional);
+    REQUIRE(limit(engine, 3, Side::Buy, 100, 10, 3, trades) == RiskResult::Accepted);
+    REQUIRE(limit(engine, 4, Side::Buy, 99, 1, 3, trades) == RiskResult::OpenNotional);
+
+    // A fill frees capacity
+    REQUIRE(limit(engine, 5, Side::Sell, 100, 15, 0, trades) == RiskResult::Accepted);
+    REQUIRE(engine.book().participant(3)->open_notional == 100 * 15);
+    REQUIRE(limit(engine, 6, Side::Buy, 100, 15, 3, trades) == RiskResult::Accepted);
+
+    // So does a cancel
+    REQUIRE(limit(engine, 7, Side::Buy, 100, 1, 3, trades) == RiskResult::OpenNotional);
+    REQUIRE(engine.book().cancel_order(6));
+    REQUIRE(limit(engine, 7, Side::Buy, 100, 1, 3, trades) == RiskResult::Accepted);
+}
+
+TEST_CASE("Modifies that add risk are checked", "[risk]") {
+    MatchingEngine engine(1024);
+    RiskEngine& risk = engine.enable_risk_checks(16);
+    TradeBuffer trades;
+
+    RiskLimits limits;
+    limits.max_order_qty = 50;
+    limits.max_open_notional = 5900;
+    risk.set_limits(4, limits);
+
+    REQUIRE(limit(engine, 1, Side::Buy, 100, 40, 4, trades) == RiskResult::Accepted);
+
+    REQUIRE_FALSE(engine.modify_order(1, 100, 51, 10, trades));   // size
+    REQUIRE(limit(engine, 2, Side::Buy, 100, 10, 4, trades) == RiskResult::Accepted);
+    REQUIRE_FALSE(engine.modify_order(1, 100, 50, 11, trades));   // notional: 100 * (50 + 10) > 5900
+    REQUIRE(engine.book().order_index().at(1)->remaining == 40);
+
+    REQUIRE(engine.modify_order(1, 100, 20, 13, trades));    // size-down always passes
+    REQUIRE_FALSE(engine.modify_order(1, 101, 50, 14, trades));   // 101 * 50 + 100 * 10 > 5900
+    REQUIRE(engine.modify_order(1, 101, 40, 15, trades));    // 101 * 40 + 100 * 10 <= 5900
+    REQUIRE(risk.rejected(4) == 3);
+}
+
+TEST_CASE("Message rate is throttled per window", "[risk]") {
+    MatchingEngine engine(1024);
+    RiskEngine& risk = engine.enable_risk_checks(16);
+    TradeBuffer trades;
+
+    RiskLimits limits;
+    limits.max_messages = 3;
+    limits.rate_window_ns = 1000;
+    risk.set_limits(5, limits);
+
+    REQUIRE(limit(engine, 1, Side::Buy, 100, 1, 5, trades, 1000) == RiskResult::Accepted);
+    REQUIRE(limit(engine, 2, Side::Buy, 100, 1, 5, trades, 1200) == RiskResult::Accepted);
+    REQUIRE(limit(engine, 3, Side::Buy, 100, 1, 5, trades, 1400) == RiskResult::Accepted);
+    REQUIRE(limit(engine, 4, Side::Buy, 100, 1, 5, trades, 1600) == RiskResult::MessageRate);
+    REQUIRE_FALSE(engine.modify_order(1, 99, 1, 1800, trades));
+
+    // New window
+    REQUIRE(limit(engine, 5, Side::Buy, 100, 1, 5, trades, 2000) == RiskResult::Accepted);
+
+    // Cancels are never throttled
+    REQUIRE(engine.book().cancel_order(2));
+}
+
+TEST_CASE("Kill switch from another thread flattens on poll_risk", "[risk]") {
+    MatchingEngine engine(1 << 12);
+    RiskEngine& risk = engine.enable_risk_checks(64);
+    TradeBuffer trades;
+
+    RiskLimits limits;
+    risk.set_limits(1, limits);
+    risk.set_limits(2, limits);
+
+    for (OrderId id = 1; id <= 200; ++id) {
+        const ParticipantId owner = (id % 2) ? 1 : 2;
+        const Side side = (id % 4 < 2) ? Side::Buy : Side::Sell;
+        REQUIRE(limit(engine, id, side, side == Side::Buy ? 90 : 110, 5, owner, trades)
+                == RiskResult::Accepted);
+    }
+    REQUIRE(engine.book().participant(1)->open_orders == 100);
+
+    std::thread monitor([&] { risk.kill(1); });
+    monitor.join();
+
+    REQUIRE(risk.killed(1));
+    REQUIRE(engine.book().participant(1)->open_orders == 100);   // not yet: engine thread applies it
+
+    // No new command needed: the engine thread polls
+    REQUIRE(engine.poll_risk() == 100);
+    REQUIRE(engine.book().participant(1)->open_orders == 0);
+    REQUIRE(engine.book().participant(2)->open_orders == 100);
+    REQUIRE(engine.poll_risk() == 0);
+
+    REQUIRE(limit(engine, 1001, Side::Buy, 90, 1, 1, trades) == RiskResult::KillSwitch);
+
+    risk.revive(1);
+    REQUIRE(limit(engine, 1002, Side::Buy, 90, 1, 1, trades) == RiskResult::Accepted);
+}
+
+TEST_CASE("Replay applies a kill before the next event", "[risk]") {
+    MatchingEngine engine(1 << 10);
+    RiskEngine& risk = engine.enable_risk_checks(16);
+    risk.set_limits(3, RiskLimits{});
+
+    PaperTradingEngine paper(engine);
+    std::vector<HistoricalEvent> events;
+    for (OrderId id = 1; id <= 10; ++id) {
+        events.push_back({id, EventType::LIMIT, id, Side::Buy, 100 - static_cast<Price>(id), 5,
+                          static_cast<Timestamp>(id), id <= 5 ? ParticipantId{3} : ParticipantId{0}});
+    }
+    paper.feed_events(events);
+    REQUIRE(engine.book().participant(3)->open_orders == 5);
+
+    std::thread monitor([&] { risk.kill(3); });
+    monitor.join();
+
+    // A cancel of someone else's order is enough
+    paper.feed_event({11, EventType::CANCEL, 10, Side::Buy, 0, 0, 11});
+    REQUIRE(engine.book().participant(3)->open_orders == 0);
+    REQUIRE(engine.book().size() == 4);
+}
+
+TEST_CASE("Crossing modify of an anonymous order with a kill pending", "[risk]") {
+    // Pool 64: the flat index has 128 slots. Pick ids sharing one home slot
+    // (the index's Fibonacci hash), so they sit in one probe run in
+    // insertion order: killed, target, bystander.
+    MatchingEngine engine(64);
+    RiskEngine& risk = engine.enable_risk_checks(16);
+    risk.set_limits(1, RiskLimits{});
+    TradeBuffer trades;
+
+    auto home = [](OrderId id) { return (id * 0x9E3779B97F4A7C15ULL) >> 57; };
+    std::vector<OrderId> run;
+    for (OrderId id = 100; run.size() < 3; ++id) {
+        if (home(id) == home(100)) run.push_back(id);
+    }
+    const OrderId killed = run[0], target = run[1], bystander = run[2];
+
+    REQUIRE(limit(engine, 1, Side::Sell, 110, 1, 0, trades) == RiskResult::Accepted);
+    REQUIRE(limit(engine, killed, Side::Buy, 90, 1, 1, trades) == RiskResult::Accepted);
+    REQUIRE(limit(engine, target, Side::Buy, 91, 1, 0, trades) == RiskResult::Accepted);
+    REQUIRE(limit(engine, bystander, Side::Buy, 92, 1, 0, trades) == RiskResult::Accepted);
+
+    // The kill's erase shifts target and bystander back one slot each
+    risk.kill(1);
+    REQUIRE(engine.modify_order(target, 110, 1, 500, trades));
+    REQUIRE(trades.size() == 1);
+    REQUIRE(engine.book().participant(1)->open_orders == 0);
+
+    REQUIRE(engine.book().size() == 1);
+    REQUIRE(engine.book().order_index().count(target) == 0);
+    REQUIRE(engine.book().order_index().count(killed) == 0);
+    REQUIRE(engine.book().order_index().at(bystander)->price == 92);
+    REQUIRE(engine.book().best_bid()->head->id == bystander);
+}
+
+TEST_CASE("Risk check cost", "[risk][perf]") {
+    MatchingEngine engine(1 << 12);
+    RiskEngine& risk = engine.enable_risk_checks(1024);
+
+    RiskLimits limits;
+    limits.max_order_qty = 1000;
+    limits.price_collar = 10;
+    limits.max_open_notional = 1'000'000'000;
+    limits.max_messages = 1'000'000'000;
+    for (ParticipantId p = 1; p < 1024; ++p) risk.set_limits(p, limits);
+
+    engine.book().add_limit_order_no_match(1, Side::Buy, 99, 10, 1);
+    engine.book().add_limit_order_no_match(2, Side::Sell, 101, 10, 2);
+
+    Order probe{};
+    probe.side = Side::Buy;
+    probe.price = 100;
+    probe.qty = 10;
+
+    constexpr int kChecks = 1'000'000;
+    std::size_t accepted = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kChecks; ++i) {
+        probe.owner = 1 + static_cast<ParticipantId>(i % 1023);
+        probe.ts = static_cast<Timestamp>(i);
+        accepted += risk.check_order(probe) == RiskResult::Accepted;
+    }
+    auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    REQUIRE(accepted == kChecks);
+    std::cout << "risk check: " << ns / kChecks << " ns\n";
+}
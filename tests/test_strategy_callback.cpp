@@ -33,4 +33,37 @@ TEST_CASE("PaperTradingEngine strategy callback", "[strategy]") {
 
     REQUIRE(callback_called);   // Confirm callback executed
     REQUIRE(engine.book().size() == 0);  // Both orders matched
-}
\ No newline at end of file
+}
+
+TEST_CASE("replay_event keys orders by event id", "[strategy]") {
+    lob::MatchingEngine engine(1024);
+    lob::PaperTradingEngine paper(engine);
+
+    lob::HistoricalEvent add{};
+    add.type = lob::EventType::LIMIT;
+    add.id = 5;
+    add.order_id = 99;   // ignored by replay_event
+    add.side = Side::Buy;
+    add.price = 100;
+    add.qty = 10;
+    add.ts = 1;
+    paper.replay_event(add);
+
+    REQUIRE(engine.book().order_index().count(5) == 1);
+    REQUIRE(engine.book().order_index().count(99) == 0);
+
+    lob::HistoricalEvent modify = add;
+    modify.type = lob::EventType::MODIFY;
+    modify.qty = 4;
+    paper.replay_event(modify);
+    REQUIRE(engine.book().order_index().at(5)->remaining == 4);
+
+    lob::HistoricalEvent cancel = add;
+    cancel.type = lob::EventType::CANCEL;
+    paper.replay_event(cancel);
+    REQUIRE(engine.book().size() == 0);
+
+    // Trades reach the callback only; the recorded buffers are feed_event's
+    REQUIRE(paper.trades().empty());
+    REQUIRE(paper.analytics().empty());
+}
@@ -0,0 +1,197 @@
+#include <catch2/catch_test_macros.hpp>
+#include "lob/paper_trader.hpp"
+#include "lob/strategy_engine.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace lob;
+
+namespace {
+
+struct CountingStrategy {
+    std::size_t trades = 0;
+    std::size_t book_updates = 0;
+    std::size_t batch_events = 0;
+    std::size_t batches = 0;
+    Quantity volume = 0;
+
+    void on_trade(const TradeEvent& t) {
+        ++trades;
+        volume += t.quantity;
+    }
+    void on_book_update(const OrderBook&, const HistoricalEvent&) { ++book_updates; }
+    void on_event_batch(std::span<const HistoricalEvent> batch) {
+        ++batches;
+        batch_events += batch.size();
+    }
+};
+
+struct TradeOnly {
+    Quantity volume = 0;
+    int64_t checksum = 0;
+    void on_trade(const TradeEvent& t) {
+        volume += t.quantity;
+        checksum = checksum * 31 + t.price * t.quantity;
+    }
+};
+
+struct VolumeOnly {
+    std::size_t trades = 0;
+    Quantity volume = 0;
+    void on_trade(const TradeEvent& t) {
+        ++trades;
+        volume += t.quantity;
+    }
+};
+
+struct BatchOnly {
+    std::size_t events = 0;
+    std::size_t batches = 0;
+    void on_event_batch(std::span<const HistoricalEvent> batch) {
+        ++batches;
+        events += batch.size();
+    }
+};
+
+static_assert(Strategy<CountingStrategy>);
+static_assert(Strategy<TradeOnly>);
+static_assert(Strategy<CallbackStrategy>);
+static_assert(!BookUpdateHook<TradeOnly>);
+
+std::vector<HistoricalEvent> crossing_events(std::size_t n)
+{
+    std::mt19937 rng(4242);
+    std::uniform_int_distribution<int> side_dist(0, 1);
+    std::uniform_int_distribution<int> price_dist(95, 105);
+    std::uniform_int_distribution<int> qty_dist(1, 20);
+
+    std::vector<HistoricalEvent> events;
+    events.reserve(n);
+    for (std::size_t i = 1; i <= n; ++i) {
+        events.push_back({i, EventType::LIMIT, i,
+                          side_dist(rng) == 0 ? Side::Buy : Side::Sell,
+                          price_dist(rng), qty_dist(rng), i});
+    }
+    return events;
+}
+
+} // namespace
+
+TEST_CASE("StrategyEngine fires all hooks", "[strategy]") {
+    StrategyEngine<CountingStrategy> engine(1024);
+
+    std::vector<HistoricalEvent> events = {
+        {1, EventType::LIMIT, 1, Side::Sell, 100, 10, 1},
+        {2, EventType::LIMIT, 2, Side::Buy, 100, 4, 2},
+        {3, EventType::LIMIT, 3, Side::Buy, 101, 10, 3},
+    };
+    engine.feed_events(events);
+
+    const auto& s = engine.strategy();
+    REQUIRE(s.trades == 2);
+    REQUIRE(s.volume == 10);
+    REQUIRE(s.book_updates == 3);
+    REQUIRE(s.batches == 1);
+    REQUIRE(s.batch_events == 3);
+    REQUIRE(engine.trades().size() == 2);
+    REQUIRE(engine.analytics().size() == 3);
+
+    engine.feed_event({4, EventType::CANCEL, 3, Side::Buy, 0, 0, 4});
+    REQUIRE(engine.strategy().batches == 2);
+    REQUIRE(engine.strategy().book_updates == 4);
+}
+
+TEST_CASE("PaperTradingEngine feed_events invokes the callback", "[strategy]") {
+    PaperTradingEngine paper(1024);
+    std::size_t calls = 0;
+    paper.set_strategy_callback([&](const TradeEvent&) { ++calls; });
+
+    paper.feed_events({
+        {1, EventType::LIMIT, 1, Side::Sell, 100, 10, 1},
+        {2, EventType::LIMIT, 2, Side::Buy, 100, 10, 2},
+    });
+
+    REQUIRE(calls == 1);
+}
+
+TEST_CASE("Every replay path delivers the same hooks", "[strategy]") {
+    auto events = crossing_events(5000);
+
+    StrategyEngine<CountingStrategy> sequential(1 << 14);
+    StrategyEngine<CountingStrategy> pipelined(1 << 14);
+    StrategyEngine<BatchOnly> pipelined_batch(1 << 14);
+
+    sequential.feed_events(events);
+    pipelined.feed_events_pipelined(events, 64, 100);
+    pipelined_batch.feed_events_pipelined(events, 64, 100);
+
+    REQUIRE(sequential.strategy().trades > 0);
+    REQUIRE(sequential.strategy().trades == pipelined.strategy().trades);
+    REQUIRE(sequential.strategy().volume == pipelined.strategy().volume);
+    REQUIRE(pipelined.strategy().book_updates == events.size());
+    REQUIRE(pipelined.strategy().batch_events == events.size());
+    REQUIRE(pipelined.strategy().batches == 50);
+
+    REQUIRE(pipelined_batch.strategy().events == events.size());
+    REQUIRE(pipelined_batch.strategy().batches == 50);
+}
+
+TEST_CASE("Template strategy vs std::function callback", "[strategy][perf]") {
+    auto events = crossing_events(200000);
+
+    PaperTradingEngine paper(1 << 18);
+    TradeOnly erased;
+    paper.set_strategy_callback([&](const TradeEvent& t) { erased.on_trade(t); });
+
+    StrategyEngine<TradeOnly> templated(1 << 18);
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    paper.feed_events(events);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    templated.feed_events(events);
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    REQUIRE(erased.volume == templated.strategy().volume);
+    REQUIRE(erased.checksum == templated.strategy().checksum);
+
+    // End to end, matching dominates: the hook is one call per trade
+    std::cout << "End to end, std::function callback: "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms\n";
+    std::cout << "End to end, template strategy:      "
+              << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms\n";
+
+    // Hook-heavy: deliver a cache-resident slice of the day's trades through
+    // the same per-trade loop replay_one runs, many times over, with no
+    // matching in between. This is the part of the replay the two bindings
+    // actually differ in.
+    REQUIRE(templated.trades().size() > 4096);
+    const std::span<const TradeEvent> day(templated.trades().data(), 4096);
+    constexpr int kRounds = 2000;
+
+    VolumeOnly direct;
+    VolumeOnly target;
+    CallbackStrategy callback{[&](const TradeEvent& t) { target.on_trade(t); }};
+
+    auto deliver = [&](auto& strategy) {
+        for (int r = 0; r < kRounds; ++r) {
+            for (const auto& t : day) strategy.on_trade(t);
+        }
+    };
+
+    auto h0 = std::chrono::high_resolution_clock::now();
+    deliver(callback);
+    auto h1 = std::chrono::high_resolution_clock::now();
+    deliver(direct);
+    auto h2 = std::chrono::high_resolution_clock::now();
+
+    REQUIRE(direct.volume == target.volume);
+    REQUIRE(direct.trades == target.trades);
+
+    const double erased_ns = std::chrono::duration<double, std::nano>(h1 - h0).count()
+                             / static_cast<double>(direct.trades);
+    const double direct_ns = std::chrono::duration<double, std::nano>(h2 - h1).count()
+                             / static_cast<double>(direct.trades);
+    std::cout << "Per hook call, std::function: " << erased_ns << " ns, template: "
+              << direct_ns << " ns (" << erased_ns / direct_ns << "x)\n";
+}